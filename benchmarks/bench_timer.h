@@ -0,0 +1,41 @@
+#ifndef BENCH_TIMER_H
+#define BENCH_TIMER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+
+// Время выполнения функции в миллисекундах (лучшее из нескольких повторов)
+template<typename Function>
+double measureMs(Function function, int repeats = 3)
+{
+    double best = 0.0;
+    for (int i = 0; i < repeats; ++i)
+    {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        if (i == 0 || elapsed.count() < best)
+            best = elapsed.count();
+    }
+    return best;
+}
+
+// Запись результата, чтобы компилятор не выбросил измеряемый код
+inline volatile std::size_t benchSink;
+
+inline void keepResult(std::size_t value)
+{
+    benchSink = value;
+}
+
+// Проверка инварианта: при нарушении программа завершается с ошибкой
+inline void expect(bool condition, const char* what)
+{
+    if (condition) return;
+    std::fprintf(stderr, "FAILED: %s\n", what);
+    std::exit(1);
+}
+
+#endif // BENCH_TIMER_H
@@ -0,0 +1,14 @@
+# Общие настройки бенчмарков
+QT -= gui
+CONFIG += console c++17 release
+CONFIG -= app_bundle
+
+# Те же флаги оптимизации, что и у приложения (см. greenPharmacy.pro)
+!msvc {
+    QMAKE_CXXFLAGS_RELEASE -= -O2
+    QMAKE_CXXFLAGS_RELEASE += -O3
+}
+
+INCLUDEPATH += $$PWD/.. $$PWD
+
+HEADERS += $$PWD/bench_timer.h
@@ -0,0 +1,11 @@
+# Бенчмарки и нагрузочные проверки (консольные программы без интерфейса).
+# Сборка: qmake benchmarks.pro && make, запуск - из каталогов программ.
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    catalog_lookup \
+    checkout_throughput \
+    concurrent_tree_stress \
+    stock_totals \
+    tree_comparator \
+    tree_insert
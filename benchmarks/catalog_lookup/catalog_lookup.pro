@@ -0,0 +1,6 @@
+include(../benchmarks.pri)
+include(../model.pri)
+
+TARGET = catalog_lookup
+
+SOURCES += main.cpp
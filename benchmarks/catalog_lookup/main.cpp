@@ -0,0 +1,121 @@
+// Поиск в каталоге и на складах по интернированным ID против прежних
+// словарей std::map со строковыми ключами, плюс прирост резидентной памяти
+// на строку склада. Запуск: catalog_lookup [аптек] [продуктов].
+#include "bench_timer.h"
+#include "my_inheritence/pharmacymanager.h"
+#include "my_inheritence/tablet.h"
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+namespace
+{
+double residentMb()                                                           // Резидентная память процесса
+{
+    long pages = 0;
+    long resident = 0;
+    if (FILE* statm = std::fopen("/proc/self/statm", "r"))
+    {
+        if (std::fscanf(statm, "%ld %ld", &pages, &resident) != 2)
+            resident = 0;
+        std::fclose(statm);
+    }
+    return resident * static_cast<double>(sysconf(_SC_PAGESIZE)) / (1024.0 * 1024.0);
+}
+
+std::string productId(int index)
+{
+    return std::to_string(100000 + index);                                     // ID продукта - только цифры
+}
+}
+
+int main(int argc, char* argv[])
+{
+    const int pharmacies = argc > 1 ? std::atoi(argv[1]) : 50;
+    const int products = argc > 2 ? std::atoi(argv[2]) : 20000;
+
+    std::vector<std::shared_ptr<MedicalProduct>> catalog;
+    catalog.reserve(products);
+    for (int i = 0; i < products; ++i)
+        catalog.push_back(std::make_shared<Tablet>(productId(i), "Tablet " + std::to_string(i), 10.0 + i % 90,
+                                                   SafeDate(2030, 1, 1), "Russia", false, "substance", "oral",
+                                                   20, 0.5, "film"));
+
+    std::mt19937 random(7);
+    std::vector<std::string> probes(200000);                                  // ID запросов (как из интерфейса - строки)
+    for (auto& probe : probes)
+        probe = productId(static_cast<int>(random() % products));
+
+    // Каталог: ID -> продукт
+    PharmacyManager manager;
+    for (const auto& product : catalog)
+        manager.addProduct(product);
+
+    std::map<std::string, std::shared_ptr<MedicalProduct>> stringCatalog;     // Прежнее устройство каталога
+    for (const auto& product : catalog)
+        stringCatalog.emplace(product->getId(), product);
+
+    double handleMs = measureMs([&] {
+        size_t found = 0;
+        for (const auto& probe : probes)
+            found += manager.getProduct(probe) ? 1 : 0;
+        expect(found == probes.size(), "every probe is in the catalog");
+        keepResult(found);
+    });
+    double mapMs = measureMs([&] {
+        size_t found = 0;
+        for (const auto& probe : probes)
+            found += stringCatalog.find(probe) != stringCatalog.end() ? 1 : 0;
+        keepResult(found);
+    });
+
+    std::printf("catalog, %d products, %zu lookups by string ID\n", products, probes.size());
+    std::printf("  handle_map (intern + probe)   %7.1f ns/lookup\n", handleMs * 1e6 / probes.size());
+    std::printf("  std::map<std::string>         %7.1f ns/lookup\n", mapMs * 1e6 / probes.size());
+
+    // Склады: каждая аптека хранит весь ассортимент
+    double before = residentMb();
+    std::vector<std::shared_ptr<Pharmacy>> network;
+    for (int p = 0; p < pharmacies; ++p)
+    {
+        auto pharmacy = std::make_shared<Pharmacy>("PH-" + std::to_string(p), "Pharmacy", "Address", "Phone", 1000.0);
+        for (int i = 0; i < products; ++i)
+            pharmacy->addToStorage(catalog[i], 1 + i % 50);
+        network.push_back(pharmacy);
+    }
+    double storagesMb = residentMb() - before;
+
+    before = residentMb();
+    std::vector<std::map<std::string, std::pair<std::shared_ptr<MedicalProduct>, int>>> stringStorages(pharmacies);
+    for (auto& storage : stringStorages)                                      // Прежнее устройство склада
+        for (int i = 0; i < products; ++i)
+            storage.emplace(catalog[i]->getId(), std::make_pair(catalog[i], 1 + i % 50));
+    double stringStoragesMb = residentMb() - before;
+
+    double stockMs = measureMs([&] {
+        long long units = 0;
+        for (size_t i = 0; i < probes.size(); ++i)
+            units += network[i % network.size()]->checkStock(probes[i]);
+        keepResult(static_cast<size_t>(units));
+    });
+    double stringStockMs = measureMs([&] {
+        long long units = 0;
+        for (size_t i = 0; i < probes.size(); ++i)
+        {
+            const auto& storage = stringStorages[i % stringStorages.size()];
+            auto it = storage.find(probes[i]);
+            units += it != storage.end() ? it->second.second : 0;
+        }
+        keepResult(static_cast<size_t>(units));
+    });
+
+    const double rows = static_cast<double>(pharmacies) * products;
+    std::printf("storages, %d pharmacies x %d products\n", pharmacies, products);
+    std::printf("  Storage (handle rows)         %7.1f ns/checkStock  %7.1f MB  %5.0f B/row\n",
+                stockMs * 1e6 / probes.size(), storagesMb, storagesMb * 1024 * 1024 / rows);
+    std::printf("  std::map<std::string>         %7.1f ns/find        %7.1f MB  %5.0f B/row\n",
+                stringStockMs * 1e6 / probes.size(), stringStoragesMb, stringStoragesMb * 1024 * 1024 / rows);
+    return 0;
+}
@@ -0,0 +1,7 @@
+include(../benchmarks.pri)
+include(../model.pri)
+
+TARGET = checkout_throughput
+CONFIG += thread
+
+SOURCES += main.cpp
@@ -0,0 +1,111 @@
+// Пропускная способность касс: N потоков продают случайные продукты в
+// случайных аптеках сети (бронь + подтверждение или прямое списание),
+// менеджер сети подключен и ведет индекс наличия. Для сравнения -
+// те же продажи в аптеках без менеджера. После прогона индекс наличия
+// менеджера сверяется со складами.
+// Запуск: checkout_throughput [аптек] [продуктов] [продаж]; под TSan -
+// сборка с -fsanitize=thread.
+#include "bench_timer.h"
+#include "my_inheritence/pharmacymanager.h"
+#include "my_inheritence/tablet.h"
+#include <thread>
+#include <vector>
+
+namespace
+{
+using Network = std::vector<std::shared_ptr<Pharmacy>>;
+
+std::string productId(int index)
+{
+    return std::to_string(100000 + index);                                     // ID продукта - только цифры
+}
+
+Network makeNetwork(const std::vector<std::shared_ptr<MedicalProduct>>& catalog, int pharmacies, int stock)
+{
+    Network network;
+    for (int p = 0; p < pharmacies; ++p)
+    {
+        auto pharmacy = std::make_shared<Pharmacy>("PH-" + std::to_string(p), "Pharmacy", "Address", "Phone", 1000.0);
+        for (const auto& product : catalog)
+            pharmacy->addToStorage(product, stock);
+        network.push_back(pharmacy);
+    }
+    return network;
+}
+
+void cashier(const Network& network, const std::vector<std::string>& ids, int sales, unsigned seed)
+{
+    for (int i = 0; i < sales; ++i)
+    {
+        seed = seed * 1103515245u + 12345u;
+        Pharmacy& pharmacy = *network[(seed >> 8) % network.size()];
+        const std::string& id = ids[(seed >> 4) % ids.size()];
+        if (seed & 0x10000)                                                   // Касса с бронью
+            pharmacy.commit(pharmacy.reserve(id, 1));
+        else
+            pharmacy.removeFromStorage(id, 1);
+    }
+}
+
+double salesPerSecond(const Network& network, const std::vector<std::string>& ids, int threads, int sales)
+{
+    double ms = measureMs([&] {
+        std::vector<std::thread> cashiers;
+        for (int t = 0; t < threads; ++t)
+            cashiers.emplace_back(cashier, std::cref(network), std::cref(ids), sales / threads, 17u + t);
+        for (auto& thread : cashiers)
+            thread.join();
+    });
+    return (sales / threads) * threads / (ms / 1000.0);
+}
+}
+
+int main(int argc, char* argv[])
+{
+    const int pharmacies = argc > 1 ? std::atoi(argv[1]) : 8;
+    const int products = argc > 2 ? std::atoi(argv[2]) : 2000;
+    const int sales = argc > 3 ? std::atoi(argv[3]) : 400000;
+    const int threadCounts[] = { 1, 2, 4, 8 };
+
+    std::vector<std::shared_ptr<MedicalProduct>> catalog;
+    std::vector<std::string> ids;
+    for (int i = 0; i < products; ++i)
+    {
+        catalog.push_back(std::make_shared<Tablet>(productId(i), "Tablet " + std::to_string(i), 10.0 + i % 90,
+                                                   SafeDate(2030, 1, 1), "Russia", false, "substance", "oral",
+                                                   20, 0.5, "film"));
+        ids.push_back(catalog.back()->getId());
+    }
+    const int stock = sales * 3 * 4;                                          // Хватит на все прогоны даже в одной строке
+
+    PharmacyManager manager;
+    for (const auto& product : catalog)
+        manager.addProduct(product);
+    Network managed = makeNetwork(catalog, pharmacies, stock);
+    for (const auto& pharmacy : managed)
+        manager.addPharmacy(pharmacy);
+    Network standalone = makeNetwork(catalog, pharmacies, stock);             // Те же аптеки без слушателя
+
+    std::printf("checkout, %d pharmacies x %d products, %d sales per run, %u hardware threads\n",
+                pharmacies, products, sales, std::thread::hardware_concurrency());
+    std::printf("  threads   with manager     without manager\n");
+    for (int threads : threadCounts)
+    {
+        double managedRate = salesPerSecond(managed, ids, threads, sales);
+        double standaloneRate = salesPerSecond(standalone, ids, threads, sales);
+        std::printf("  %7d   %9.0f /s     %9.0f /s\n", threads, managedRate, standaloneRate);
+    }
+
+    for (const auto& id : ids)                                                // Индекс наличия менеджера против складов
+    {
+        auto availability = manager.getProductAvailability(id);
+        for (const auto& pharmacy : managed)
+        {
+            auto level = availability.find(pharmacy->getId());
+            int indexed = level != availability.end() ? level->second : 0;
+            expect(indexed == pharmacy->checkStock(id), "availability index matches the storages");
+        }
+    }
+    std::printf("availability index matches %d storages\n", pharmacies);
+    return 0;
+}
@@ -0,0 +1,6 @@
+include(../benchmarks.pri)
+
+TARGET = concurrent_tree_stress
+CONFIG += thread
+
+SOURCES += main.cpp
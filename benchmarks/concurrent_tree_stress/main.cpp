@@ -0,0 +1,160 @@
+// Нагрузочная проверка concurrent_tree: один писатель вставляет ключи
+// 0..N-1 по возрастанию, затем удаляет их в том же порядке, а читатели
+// параллельно ищут ключи и берут снимки. Писатель публикует счетчики
+// начатых и завершенных операций, поэтому читатель проверяет
+// линеаризуемость: операция, завершившаяся до начала поиска, обязана быть
+// видна, операция, не начавшаяся до его конца, - не видна, а снимок
+// всегда содержит непрерывный отрезок ключей. Затем читатели по секунде
+// ищут в полном дереве: одни и вместе с писателем, заменяющим последний
+// ключ, - для сравнения пропускной способности чтения под нагрузкой записи.
+// Запуск: concurrent_tree_stress [читателей] [ключей]; под TSan - сборка
+// с -fsanitize=thread.
+#include "bench_timer.h"
+#include "my_binary_tree/concurrent_tree.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace
+{
+using Tree = concurrent_tree<int>;
+
+struct Progress
+{
+    std::atomic<int> inserting{0};                                            // Вставка ключей [0, inserting) начата
+    std::atomic<int> inserted{0};                                             // Ключи [0, inserted) уже вставлены
+    std::atomic<int> erasing{0};                                              // Удаление ключей [0, erasing) начато
+    std::atomic<int> erased{0};                                               // Ключи [0, erased) уже удалены
+    std::atomic<bool> done{false};
+    std::atomic<long long> lookups{0};
+    std::atomic<long long> snapshots{0};
+};
+
+void checkSnapshot(const Tree::version_type& snapshot, int count)
+{
+    size_t size = snapshot.size();
+    if (size == 0) return;
+
+    int first = *snapshot.begin();                                            // Снимок - отрезок [first, first + size)
+    expect(first >= 0 && first + static_cast<int>(size) <= count, "snapshot stays within the key range");
+    expect(snapshot.contains(first + static_cast<int>(size) - 1), "snapshot is a contiguous range");
+
+    if (size <= 64)                                                           // Небольшие снимки проверяются целиком
+    {
+        int expected = first;
+        for (int key : snapshot)
+            expect(key == expected++, "snapshot iterates in order without gaps");
+    }
+}
+
+void reader(const Tree& tree, Progress& progress, int count, unsigned seed)
+{
+    long long lookups = 0;
+    long long snapshots = 0;
+    while (!progress.done.load(std::memory_order_acquire))
+    {
+        seed = seed * 1103515245u + 12345u;
+        int key = static_cast<int>((seed >> 4) % static_cast<unsigned>(count));
+
+        int inserted = progress.inserted.load(std::memory_order_acquire);    // Завершено до начала поиска
+        int erased = progress.erased.load(std::memory_order_acquire);
+        bool found = tree.contains(key);
+        int inserting = progress.inserting.load(std::memory_order_acquire);  // Начато до конца поиска
+        int erasing = progress.erasing.load(std::memory_order_acquire);
+
+        if (key < inserted && key >= erasing)                                 // Вставлен и удаление не начиналось
+            expect(found, "completed insert is visible");
+        if (key < erased || key >= inserting)                                 // Удален или вставка не начиналась
+            expect(!found, "completed erase is visible and no key appears early");
+        ++lookups;
+
+        if ((seed & 0xFF) == 0)                                               // Изредка - снимок
+        {
+            checkSnapshot(tree.snapshot(), count);
+            ++snapshots;
+        }
+    }
+    progress.lookups += lookups;
+    progress.snapshots += snapshots;
+}
+
+// Читатели ищут в заполненном дереве, пока в главном потоке выполняется
+// load; писатель может менять только последний ключ. Результат - число поисков.
+template<typename Load>
+long long readLoad(const Tree& tree, int readers, int count, Load load)
+{
+    Progress progress;
+    progress.inserted.store(count - 1);                                       // Последний ключ может отсутствовать
+    progress.inserting.store(count);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < readers; ++i)
+        threads.emplace_back(reader, std::cref(tree), std::ref(progress), count, 104729u * (i + 1));
+    load();
+    progress.done.store(true, std::memory_order_release);
+    for (auto& thread : threads)
+        thread.join();
+    return progress.lookups.load();
+}
+}
+
+int main(int argc, char* argv[])
+{
+    const int readers = argc > 1 ? std::atoi(argv[1]) : 4;
+    const int count = argc > 2 ? std::atoi(argv[2]) : 200000;
+
+    Tree tree;
+    Progress progress;
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < readers; ++i)
+        threads.emplace_back(reader, std::cref(tree), std::ref(progress), count, 7919u * (i + 1));
+
+    double writerMs = measureMs([&] {
+        for (int key = 0; key < count; ++key)
+        {
+            progress.inserting.store(key + 1, std::memory_order_release);    // Вставка начата
+            expect(tree.insert(key), "insert of a new key succeeds");
+            progress.inserted.store(key + 1, std::memory_order_release);     // Вставка завершена
+        }
+        for (int key = 0; key < count; ++key)
+        {
+            progress.erasing.store(key + 1, std::memory_order_release);      // Удаление начато
+            expect(tree.erase(key), "erase of a present key succeeds");
+            progress.erased.store(key + 1, std::memory_order_release);       // Удаление завершено
+        }
+    }, 1);
+
+    progress.done.store(true, std::memory_order_release);
+    for (auto& thread : threads)
+        thread.join();
+
+    expect(tree.empty(), "every key erased");
+
+    Tree filled;                                                              // Пропускная способность чтения: полное дерево
+    for (int key = 0; key < count; ++key)
+        filled.insert(key);
+    const auto window = std::chrono::milliseconds(1000);
+    long long alone = readLoad(filled, readers, count, [&] { std::this_thread::sleep_for(window); });
+    long long writes = 0;
+    long long loaded = readLoad(filled, readers, count, [&] {
+        auto stop = std::chrono::steady_clock::now() + window;
+        while (std::chrono::steady_clock::now() < stop)                       // Писатель заменяет последний ключ
+        {
+            expect(filled.erase(count - 1), "erase of the last key succeeds");
+            expect(filled.insert(count - 1), "insert of the last key succeeds");
+            writes += 2;
+        }
+    });
+
+    std::printf("concurrent_tree, %d readers, %d keys\n", readers, count);
+    std::printf("  writer   %8.2f Mops/s (%d inserts + %d erases in %.1f ms)\n",
+                2.0 * count / writerMs / 1000.0, count, count, writerMs);
+    std::printf("  readers  %8.2f Mops/s during the check (%lld lookups, %lld snapshots checked)\n",
+                progress.lookups.load() / writerMs / 1000.0, progress.lookups.load(), progress.snapshots.load());
+    std::printf("  readers  %8.2f Mops/s on the full tree alone\n", alone / 1e6);
+    std::printf("  readers  %8.2f Mops/s on the full tree with a writer (%.2f Mwrites/s)\n",
+                loaded / 1e6, writes / 1e6);
+    std::printf("OK\n");
+    return 0;
+}
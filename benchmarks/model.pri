@@ -0,0 +1,22 @@
+# Исходники модели без интерфейса (для бенчмарков каталога, складов и менеджера)
+SOURCES += \
+    $$PWD/../Exception/safeinput.cpp \
+    $$PWD/../Files/file_txt.cpp \
+    $$PWD/../my_inheritence/filemanager.cpp \
+    $$PWD/../my_inheritence/idinterner.cpp \
+    $$PWD/../my_inheritence/inventoryoperation.cpp \
+    $$PWD/../my_inheritence/medicalproduct.cpp \
+    $$PWD/../my_inheritence/medicine.cpp \
+    $$PWD/../my_inheritence/ointment.cpp \
+    $$PWD/../my_inheritence/pharmacy.cpp \
+    $$PWD/../my_inheritence/pharmacymanager.cpp \
+    $$PWD/../my_inheritence/productregistry.cpp \
+    $$PWD/../my_inheritence/productsearchindex.cpp \
+    $$PWD/../my_inheritence/return.cpp \
+    $$PWD/../my_inheritence/safedate.cpp \
+    $$PWD/../my_inheritence/stockrecord.cpp \
+    $$PWD/../my_inheritence/storage.cpp \
+    $$PWD/../my_inheritence/supply.cpp \
+    $$PWD/../my_inheritence/syrup.cpp \
+    $$PWD/../my_inheritence/tablet.cpp \
+    $$PWD/../my_inheritence/writeoff.cpp
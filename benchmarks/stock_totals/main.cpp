@@ -0,0 +1,175 @@
+// Итоги складов для панели сети: готовые значения менеджера
+// (getNetworkTotals, getPharmacyTotals, getNetworkUnits) против пересчета
+// через Pharmacy::getAllProducts по всем аптекам, плюс цена поддержки
+// итогов на каждом изменении склада и переоценки продуктов через
+// updateProduct. Результаты обоих способов сверяются.
+// Запуск: stock_totals [аптек] [продуктов].
+#include "bench_timer.h"
+#include "my_inheritence/pharmacymanager.h"
+#include "my_inheritence/tablet.h"
+#include <cmath>
+#include <set>
+#include <vector>
+
+namespace
+{
+using Totals = PharmacyManager::StockTotals;
+
+std::string productId(int index)
+{
+    return std::to_string(100000 + index);                                     // ID продукта - только цифры
+}
+
+double ownPrice(const MedicalProduct& product)                                // Цена версии продукта на складе
+{
+    return product.getBasePrice();
+}
+
+template<typename Price = double (*)(const MedicalProduct&)>
+Totals rescanPharmacy(const Pharmacy& pharmacy, Price price = ownPrice)        // Прежний способ - обход склада
+{
+    Totals totals;
+    for (const auto& item : pharmacy.getAllProducts())
+    {
+        totals.units += item.second;
+        totals.value += item.second * price(*item.first);
+        ++totals.products;
+    }
+    return totals;
+}
+
+template<typename Price = double (*)(const MedicalProduct&)>
+Totals rescanNetwork(const std::vector<std::shared_ptr<Pharmacy>>& network, Price price = ownPrice)
+{
+    Totals totals;
+    std::set<std::string> products;                                           // Продукт учитывается один раз на сеть
+    for (const auto& pharmacy : network)
+        for (const auto& item : pharmacy->getAllProducts())
+        {
+            totals.units += item.second;
+            totals.value += item.second * price(*item.first);
+            products.insert(item.first->getId());
+        }
+    totals.products = products.size();
+    return totals;
+}
+
+bool sameTotals(const Totals& a, const Totals& b)
+{
+    return a.units == b.units && a.products == b.products && std::fabs(a.value - b.value) < 1e-6 * (1.0 + std::fabs(b.value));
+}
+}
+
+int main(int argc, char* argv[])
+{
+    const int pharmacies = argc > 1 ? std::atoi(argv[1]) : 50;
+    const int products = argc > 2 ? std::atoi(argv[2]) : 2000;
+    const int queries = 1000;
+
+    std::vector<std::shared_ptr<MedicalProduct>> catalog;
+    for (int i = 0; i < products; ++i)
+        catalog.push_back(std::make_shared<Tablet>(productId(i), "Tablet " + std::to_string(i), 10.0 + i % 90,
+                                                   SafeDate(2030, 1, 1), "Russia", false, "substance", "oral",
+                                                   20, 0.5, "film"));
+
+    PharmacyManager manager;
+    for (const auto& product : catalog)
+        manager.addProduct(product);
+
+    std::vector<std::shared_ptr<Pharmacy>> network;
+    for (int p = 0; p < pharmacies; ++p)
+    {
+        auto pharmacy = std::make_shared<Pharmacy>("PH-" + std::to_string(p), "Pharmacy", "Address", "Phone", 1000.0);
+        for (int i = p % 3; i < products; i += 1 + p % 3)                     // Ассортимент аптек различается
+            pharmacy->addToStorage(catalog[i], 1 + (i + p) % 50);
+        manager.addPharmacy(pharmacy);
+        network.push_back(pharmacy);
+    }
+
+    // Панель сети: итоги сети и всех аптек
+    expect(sameTotals(manager.getNetworkTotals(), rescanNetwork(network)), "network totals match a rescan");
+    for (const auto& pharmacy : network)
+        expect(sameTotals(manager.getPharmacyTotals(pharmacy->getId()), rescanPharmacy(*pharmacy)),
+               "pharmacy totals match a rescan");
+
+    double keptMs = measureMs([&] {
+        long long units = 0;
+        for (int q = 0; q < queries; ++q)
+        {
+            units += manager.getNetworkTotals().units;
+            for (const auto& pharmacy : network)
+                units += manager.getPharmacyTotals(pharmacy->getId()).units;
+        }
+        keepResult(static_cast<size_t>(units));
+    });
+    double rescanMs = measureMs([&] {
+        long long units = rescanNetwork(network).units;
+        for (const auto& pharmacy : network)
+            units += rescanPharmacy(*pharmacy).units;
+        keepResult(static_cast<size_t>(units));
+    });
+
+    // Остаток одного продукта по сети
+    double unitsMs = measureMs([&] {
+        long long units = 0;
+        for (int q = 0; q < queries; ++q)
+            units += manager.getNetworkUnits(catalog[q % products]->getId());
+        keepResult(static_cast<size_t>(units));
+    });
+    double unitsRescanMs = measureMs([&] {
+        long long units = 0;
+        for (int q = 0; q < queries; ++q)
+            for (const auto& pharmacy : network)
+                units += pharmacy->checkStock(catalog[q % products]->getId());
+        keepResult(static_cast<size_t>(units));
+    }, 1);
+
+    // Цена поддержки итогов: продажа и поступление в аптеке с менеджером и без
+    auto standalone = std::make_shared<Pharmacy>(*network[0]);               // Копия склада без слушателя
+    auto churn = [&](Pharmacy& pharmacy) {
+        for (int q = 0; q < 100000; ++q)
+        {
+            const auto& product = catalog[(q * 3) % products];
+            if (pharmacy.checkStock(product->getId()) == 0) continue;          // Продукта нет в ассортименте аптеки
+            pharmacy.removeFromStorage(product->getId(), 1);
+            pharmacy.receiveLot(product, StockLot{ "", SafeDate(2025, 1, 1), SafeDate(2030, 1, 1), 1 });
+        }
+    };
+    double managedChurnMs = measureMs([&] { churn(*network[0]); });
+    double standaloneChurnMs = measureMs([&] { churn(*standalone); });
+    expect(sameTotals(manager.getPharmacyTotals(network[0]->getId()), rescanPharmacy(*network[0])),
+           "pharmacy totals match a rescan after churn");
+
+    // Переоценка: окно редактирования передает новую версию продукта, склады
+    // аптек хранят прежнюю, итоги менеджера должны перейти на новую цену
+    const int repriced = (products + 9) / 10;
+    double repriceMs = measureMs([&] {
+        for (int i = 0; i < products; i += 10)
+        {
+            const auto& old = catalog[i];
+            catalog[i] = std::make_shared<Tablet>(old->getId(), old->getName(), old->getBasePrice() + 5.0,
+                                                  SafeDate(2030, 1, 1), "Russia", false, "substance", "oral",
+                                                  20, 0.5, "film");
+            manager.updateProduct(catalog[i]);
+        }
+    }, 1);
+    auto catalogPrice = [&](const MedicalProduct& product) {
+        return catalog[std::stoi(product.getId()) - 100000]->getBasePrice();
+    };
+    expect(sameTotals(manager.getNetworkTotals(), rescanNetwork(network, catalogPrice)),
+           "network totals follow the catalog price after updateProduct");
+    for (const auto& pharmacy : network)
+        expect(sameTotals(manager.getPharmacyTotals(pharmacy->getId()), rescanPharmacy(*pharmacy, catalogPrice)),
+               "pharmacy totals follow the catalog price after updateProduct");
+
+    std::printf("totals, %d pharmacies x up to %d products\n", pharmacies, products);
+    std::printf("  dashboard (network + %d pharmacies)  kept %9.2f us   rescan %9.2f us\n",
+                pharmacies, keptMs * 1000.0 / queries, rescanMs * 1000.0);
+    std::printf("  units of one product                 kept %9.2f us   rescan %9.2f us\n",
+                unitsMs * 1000.0 / queries, unitsRescanMs * 1000.0 / queries);
+    std::printf("  sale + receipt (100k pairs)          with manager %7.1f ms   without %7.1f ms\n",
+                managedChurnMs, standaloneChurnMs);
+    std::printf("  updateProduct with a new price       %7.2f us per product (%d products)\n",
+                repriceMs * 1000.0 / repriced, repriced);
+    return 0;
+}
@@ -0,0 +1,6 @@
+include(../benchmarks.pri)
+include(../model.pri)
+
+TARGET = stock_totals
+
+SOURCES += main.cpp
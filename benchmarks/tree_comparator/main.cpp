@@ -0,0 +1,89 @@
+// Пропускная способность вставки и поиска в binaryTree при компараторе -
+// параметре шаблона (std::less, вызов встраивается) и при компараторе,
+// заданном во время выполнения (runtime_compare, вызов через std::function).
+#include "bench_timer.h"
+#include "my_binary_tree/binarytree.h"
+#include <random>
+#include <string>
+#include <vector>
+
+template<typename MakeTree, typename Key>
+static void run(const char* label, const std::vector<Key>& keys, const std::vector<Key>& probes,
+                MakeTree makeTree)
+{
+    const size_t rounds = std::max<size_t>(1, 1000000 / probes.size());     // Не меньше 1M поисков на замер
+
+    double insertMs = measureMs([&] {
+        for (size_t round = 0; round < rounds; ++round)
+        {
+            auto tree = makeTree();
+            for (const Key& key : keys)
+                tree.push(key);
+            keepResult(tree.size());
+        }
+    });
+
+    auto tree = makeTree();
+    for (const Key& key : keys)
+        tree.push(key);
+
+    double findMs = measureMs([&] {
+        size_t found = 0;
+        for (size_t round = 0; round < rounds; ++round)
+            for (const Key& key : probes)
+                found += tree.contains(key) ? 1 : 0;
+        expect(found == rounds * probes.size() / 2, "half of the probes are present");
+        keepResult(found);
+    });
+
+    const double operations = static_cast<double>(rounds * keys.size());
+    std::printf("  %-24s insert %6.2f Mops/s   find %6.2f Mops/s\n", label,
+                operations / insertMs / 1000.0, operations / findMs / 1000.0);
+}
+
+static void runSize(size_t count)
+{
+    std::mt19937 random(42);
+    std::vector<int> keys(count);
+    for (size_t i = 0; i < count; ++i)
+        keys[i] = static_cast<int>(2 * i);                                    // Четные ключи есть в дереве
+    std::shuffle(keys.begin(), keys.end(), random);
+
+    std::vector<int> probes(count);
+    for (size_t i = 0; i < count; ++i)
+        probes[i] = static_cast<int>(i);                                      // Половина проб - нечетные, промахи
+    std::shuffle(probes.begin(), probes.end(), random);
+
+    std::vector<std::string> names(count);                                    // Строковые ключи как у ID продуктов
+    std::vector<std::string> nameProbes(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        names[i] = "PRD-" + std::to_string(keys[i]);
+        nameProbes[i] = "PRD-" + std::to_string(probes[i]);
+    }
+
+    std::printf("binaryTree comparator, %zu random keys\n", count);
+
+    run("int, std::less", keys, probes, [] { return binaryTree<int>(); });
+    run("int, runtime_compare", keys, probes, [] {
+        return binaryTree<int, runtime_compare<int>>([](const int& a, const int& b) { return a < b; });
+    });
+    run("string, std::less", names, nameProbes, [] { return binaryTree<std::string>(); });
+    run("string, runtime_compare", names, nameProbes, [] {
+        return binaryTree<std::string, runtime_compare<std::string>>(
+            [](const std::string& a, const std::string& b) { return a < b; });
+    });
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc > 1)                                                             // Один размер из командной строки
+    {
+        runSize(std::strtoul(argv[1], nullptr, 10));
+        return 0;
+    }
+
+    runSize(10000);                                                           // Дерево в кэше - видна цена сравнения
+    runSize(500000);                                                          // Дерево больше кэша - преобладают промахи
+    return 0;
+}
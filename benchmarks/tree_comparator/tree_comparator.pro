@@ -0,0 +1,5 @@
+include(../benchmarks.pri)
+
+TARGET = tree_comparator
+
+SOURCES += main.cpp
@@ -0,0 +1,65 @@
+// Вставка 1M отсортированных ключей в binaryTree: вырожденный для
+// несбалансированного дерева случай. Все обходы итеративные, поэтому
+// вставка, поиск по условию, копирование и очистка не переполняют стек.
+#include "bench_timer.h"
+#include "my_binary_tree/binarytree.h"
+#include <set>
+#include <vector>
+
+int main(int argc, char* argv[])
+{
+    const int count = argc > 1 ? std::atoi(argv[1]) : 1000000;                // Количество ключей
+
+    std::vector<int> ascending(count);
+    for (int i = 0; i < count; ++i)
+        ascending[i] = i;
+    std::vector<int> descending(ascending.rbegin(), ascending.rend());
+
+    std::printf("binaryTree, %d sorted keys\n", count);
+
+    for (const std::vector<int>* keys : { &ascending, &descending })
+    {
+        const char* order = keys == &ascending ? "ascending" : "descending";
+
+        double treeMs = measureMs([&] {
+            binaryTree<int> tree;
+            for (int key : *keys)
+                tree.push(key);
+            expect(tree.size() == static_cast<size_t>(count), "all keys inserted");
+        });
+        double setMs = measureMs([&] {
+            std::set<int> reference;
+            for (int key : *keys)
+                reference.insert(key);
+            keepResult(reference.size());
+        });
+        std::printf("  push %-15s %8.1f ms  (std::set %.1f ms)\n", order, treeMs, setMs);
+    }
+
+    binaryTree<int> tree;
+    for (int key : ascending)
+        tree.push(key);
+
+    int expected = 0;                                                         // Порядок обхода
+    for (int key : tree)
+        expect(key == expected++, "in-order traversal is sorted");
+
+    double findIfMs = measureMs([&] {
+        auto it = tree.find_if([count](int key) { return key == count - 1; });
+        expect(it != tree.end(), "find_if reaches the last node");
+    });
+    double copyMs = measureMs([&] {
+        binaryTree<int> copy(tree);
+        expect(copy.size() == tree.size(), "copy keeps every node");
+    });
+    double clearMs = measureMs([&] {
+        binaryTree<int> copy(tree);
+        copy.clear();
+        expect(copy.empty(), "clear removes every node");
+    }, 1);
+
+    std::printf("  %-20s %8.1f ms\n", "find_if (full scan)", findIfMs);
+    std::printf("  %-20s %8.1f ms\n", "copy", copyMs);
+    std::printf("  %-20s %8.1f ms\n", "copy + clear", clearMs);
+    return 0;
+}
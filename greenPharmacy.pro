@@ -4,6 +4,13 @@ greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
 CONFIG += c++17
 
+# Циклы по столбцам склада (Storage::totalUnits, партии в unitsExpiringBefore)
+# GCC векторизует только начиная с -O3
+!msvc {
+    QMAKE_CXXFLAGS_RELEASE -= -O2
+    QMAKE_CXXFLAGS_RELEASE += -O3
+}
+
 # You can make your code fail to compile if it uses deprecated APIs.
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
@@ -13,12 +20,15 @@ SOURCES += \
     Files/file_txt.cpp \
     main.cpp \
     my_inheritence/filemanager.cpp \
+    my_inheritence/idinterner.cpp \
     my_inheritence/inventoryoperation.cpp \
     my_inheritence/medicalproduct.cpp \
     my_inheritence/medicine.cpp \
     my_inheritence/ointment.cpp \
     my_inheritence/pharmacy.cpp \
     my_inheritence/pharmacymanager.cpp \
+    my_inheritence/productregistry.cpp \
+    my_inheritence/productsearchindex.cpp \
     my_inheritence/return.cpp \
     my_inheritence/safedate.cpp \
     my_inheritence/stockrecord.cpp \
@@ -57,17 +67,24 @@ HEADERS += \
     Files/file_txt.h \
     file.h \
     my_binary_tree/binarytree.h \
+    my_binary_tree/concurrent_tree.h \
+    my_binary_tree/handle_map.h \
+    my_binary_tree/node_pool.h \
+    my_binary_tree/persistent_tree.h \
     my_binary_tree/reverse_tree_iterator.h \
     my_binary_tree/tree_algorithms.h \
     my_binary_tree/tree_iterator.h \
     my_binary_tree/treenode.h \
     my_inheritence/filemanager.h \
+    my_inheritence/idinterner.h \
     my_inheritence/inventoryoperation.h \
     my_inheritence/medicalproduct.h \
     my_inheritence/medicine.h \
     my_inheritence/ointment.h \
     my_inheritence/pharmacy.h \
     my_inheritence/pharmacymanager.h \
+    my_inheritence/productregistry.h \
+    my_inheritence/productsearchindex.h \
     my_inheritence/return.h \
     my_inheritence/safedate.h \
     my_inheritence/stockrecord.h \
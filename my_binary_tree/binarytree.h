@@ -2,77 +2,79 @@
 #define BINARY_TREE_H
 
 #include "treenode.h"
+#include "node_pool.h"
+#include <algorithm>
+#include <cassert>
 #include <functional>
 #include <vector>
 #include <iostream>
+#include <iterator>
 #include <stdexcept>
+#include <new>
+#include <type_traits>
+#include <utility>
 
+// Компаратор, задаваемый во время выполнения (лямбда, функция и т.п.):
+// binaryTree<T, runtime_compare<T>> tree(comp) - каждое сравнение идет через std::function
 template <typename T>
+using runtime_compare = std::function<bool(const T&, const T&)>;
+
+// Бинарное дерево поиска с балансировкой по красно-черной схеме:
+// глубина любого пути не превышает 2*log2(n + 1) независимо от порядка вставки
+// Compare - тип компаратора (как у std::map), подставляется на этапе компиляции;
+// Allocator - распределитель узлов (allocate/deallocate/release), по умолчанию пул
+template <typename T, typename Compare = std::less<T>, typename Allocator = node_pool<treeNode<T>>>
 class binaryTree
 {
 private:
     treeNode<T>* root;                                                        // Корень бинарного дерева
-    std::function<bool(const T&, const T&)> comparator;                       // Компаратор для сравнения элементов
+    treeNode<T>* leftmost;                                                    // Минимальный узел (для begin() за O(1))
+    treeNode<T>* rightmost;                                                   // Максимальный узел (для rbegin() за O(1))
+    Allocator allocator;                                                      // Распределитель памяти под узлы
+    size_t nodeCount;                                                         // Количество элементов в дереве
+    Compare comparator;                                                       // Компаратор для сравнения элементов
 
-    // Внутренний класс итератора для дерева
+    // Двунаправленный итератор симметричного обхода (Const - только чтение)
+    template <bool Const>
     class tree_iterator
     {
     private:
-        treeNode<T>* current;                                                 // Текущий узел
-        treeNode<T>* tree_root;                                               // Корень дерева (для навигации)
+        treeNode<T>* current;                                                 // Текущий узел (nullptr - конец)
+        const binaryTree* owner;                                              // Дерево (для шага назад от конца)
 
     public:
-        tree_iterator() : current(nullptr), tree_root(nullptr) {}             // Конструктор по умолчанию
-        tree_iterator(treeNode<T>* node, treeNode<T>* root = nullptr)         // Конструктор с параметрами
-            : current(node), tree_root(root) {}
-        tree_iterator(const tree_iterator& other)                             // Конструктор копирования
-            : current(other.current), tree_root(other.tree_root) {}
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = typename std::conditional<Const, const T*, T*>::type;
+        using reference = typename std::conditional<Const, const T&, T&>::type;
 
-        tree_iterator& operator=(const tree_iterator& other)                  // Оператор присваивания
-        {
-            if (this != &other)                                               // Проверка самоприсваивания
-            {
-                current = other.current;                                      // Копирование текущего узла
-                tree_root = other.tree_root;                                  // Копирование корня
-            }
-            return *this;                                                     // Возврат текущего итератора
-        }
+        tree_iterator() : current(nullptr), owner(nullptr) {}                 // Конструктор по умолчанию
+        tree_iterator(treeNode<T>* node, const binaryTree* tree)              // Конструктор с параметрами
+            : current(node), owner(tree) {}
+
+        template <bool OtherConst,                                            // Преобразование iterator -> const_iterator
+                  typename = typename std::enable_if<Const && !OtherConst>::type>
+        tree_iterator(const tree_iterator<OtherConst>& other)
+            : current(other.getNode()), owner(other.getTree()) {}
 
-        T& operator*() const                                                  // Оператор разыменования
+        reference operator*() const                                           // Оператор разыменования
         {
             if (current == nullptr)                                           // Проверка нулевого указателя
                 throw std::runtime_error("Dereferencing null iterator");
             return current->data;                                             // Возврат данных узла
         }
 
-        T* operator->() const                                                 // Оператор доступа к членам
+        pointer operator->() const                                            // Оператор доступа к членам
         {
-            if (current == nullptr)                                           // Проверка нулевого указателя
-                throw std::runtime_error("Dereferencing null iterator");
-            return &(current->data);                                          // Возврат указателя на данные
+            return &**this;
         }
 
         tree_iterator& operator++()                                           // Префиксный инкремент
         {
-            if (current == nullptr) return *this;                             // Если конец - возврат без изменений
-
-            if (current->right != nullptr)                                    // Если есть правый потомок
-            {
-                current = current->right;                                     // Переход к правому потомку
-                while (current->left != nullptr)                              // Поиск минимального в правом поддереве
-                    current = current->left;
-            }
-            else                                                              // Если нет правого потомка
-            {
-                treeNode<T>* parent = current->parent;                        // Переход к родителю
-                while (parent != nullptr && current == parent->right)         // Подъем пока текущий - правый потомок
-                {
-                    current = parent;                                         // Переход к родителю
-                    parent = parent->parent;                                  // Подъем дальше
-                }
-                current = parent;                                             // Установка нового текущего узла
-            }
-            return *this;                                                     // Возврат обновленного итератора
+            if (current != nullptr)                                           // Конец остается концом
+                current = nextNode(current);                                  // Амортизированно O(1) на шаг
+            return *this;
         }
 
         tree_iterator operator++(int)                                         // Постфиксный инкремент
@@ -82,301 +84,1352 @@ private:
             return temp;                                                      // Возврат старого значения
         }
 
-        bool operator==(const tree_iterator& other) const                     // Оператор сравнения на равенство
+        tree_iterator& operator--()                                           // Префиксный декремент
         {
-            return current == other.current;                                  // Сравнение указателей на узлы
+            if (current == nullptr)                                           // От конца - к максимальному элементу за O(1)
+                current = owner != nullptr ? owner->rightmost : nullptr;
+            else
+                current = prevNode(current);
+            return *this;
         }
 
-        bool operator!=(const tree_iterator& other) const                     // Оператор сравнения на неравенство
+        tree_iterator operator--(int)                                         // Постфиксный декремент
+        {
+            tree_iterator temp = *this;
+            --(*this);
+            return temp;
+        }
+
+        bool operator==(const tree_iterator<true>& other) const               // Оператор сравнения на равенство
+        {
+            return current == other.getNode();                                // Сравнение указателей на узлы
+        }
+
+        bool operator!=(const tree_iterator<true>& other) const               // Оператор сравнения на неравенство
         {
             return !(*this == other);                                         // Отрицание оператора равенства
         }
 
         treeNode<T>* getNode() const { return current; }                      // Получение текущего узла
+        const binaryTree* getTree() const { return owner; }                   // Дерево, по которому идет обход
     };
 
 public:
-    using iterator = tree_iterator;                                           // Псевдоним для итератора
+    using iterator = tree_iterator<false>;                                    // Псевдоним для итератора
+    using const_iterator = tree_iterator<true>;                               // Итератор только для чтения
+    using reverse_iterator = std::reverse_iterator<iterator>;                 // Обход по убыванию
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    // Дескриптор извлеченного узла: владеет узлом вне дерева (только перемещение)
+    class node_type
+    {
+    private:
+        treeNode<T>* node;                                                    // Извлеченный узел (nullptr - пусто)
+        Allocator allocator;                                                  // Распределитель, выделивший узел
+
+        friend class binaryTree;
+
+        node_type(treeNode<T>* extracted, const Allocator& alloc)             // Создается только деревом
+            : node(extracted), allocator(alloc) {}
+
+        treeNode<T>* release()                                                // Передача узла дереву
+        {
+            treeNode<T>* extracted = node;
+            node = nullptr;
+            return extracted;
+        }
+
+        void reset()                                                          // Освобождение узла
+        {
+            if (node == nullptr) return;
+            node->~treeNode<T>();
+            allocator.deallocate(node);
+            node = nullptr;
+        }
+
+    public:
+        node_type() : node(nullptr) {}                                        // Пустой дескриптор
+        node_type(node_type&& other) noexcept
+            : node(other.node), allocator(std::move(other.allocator))
+        {
+            other.node = nullptr;
+        }
+        node_type& operator=(node_type&& other) noexcept
+        {
+            if (this != &other)
+            {
+                reset();
+                node = other.node;
+                allocator = std::move(other.allocator);
+                other.node = nullptr;
+            }
+            return *this;
+        }
+        node_type(const node_type&) = delete;
+        node_type& operator=(const node_type&) = delete;
+        ~node_type() { reset(); }
+
+        bool empty() const { return node == nullptr; }
+        explicit operator bool() const { return node != nullptr; }
+        T& value() const { return node->data; }                               // Значение (ключ менять можно - узел вне дерева)
+    };
+
+    struct insert_return_type                                                 // Результат insert(node_type&&)
+    {
+        iterator position;                                                    // Вставленный или мешающий элемент
+        bool inserted;                                                        // Был ли узел вставлен
+        node_type node;                                                       // Не вставленный узел возвращается владельцу
+    };
 
     binaryTree();                                                             // Конструктор по умолчанию
-    binaryTree(std::function<bool(const T&, const T&)> comp);                 // Конструктор с компаратором
+    explicit binaryTree(const Compare& comp);                                 // Конструктор с компаратором
+    explicit binaryTree(const Allocator& alloc);                              // Дерево на распределителе другого дерева
+    binaryTree(const Compare& comp, const Allocator& alloc);
+    template<typename ForwardIterator>                                        // Построение из возрастающего диапазона за O(n)
+    binaryTree(ForwardIterator first, ForwardIterator last);
+    template<typename ForwardIterator>                                        // То же с компаратором
+    binaryTree(ForwardIterator first, ForwardIterator last, const Compare& comp);
+    binaryTree(const binaryTree& other);                                      // Глубокое копирование за O(n)
+    binaryTree(binaryTree&& other)                                            // Перемещение без копирования узлов
+        noexcept(std::is_nothrow_copy_constructible<Compare>::value);
     ~binaryTree();                                                            // Деструктор
 
+    binaryTree& operator=(const binaryTree& other);                           // Копирующее присваивание
+    binaryTree& operator=(binaryTree&& other) noexcept;                       // Перемещающее присваивание
+    void swap(binaryTree& other) noexcept;                                    // Обмен содержимым за O(1)
+
+    Compare key_comp() const { return comparator; }                           // Копия компаратора дерева
+    Allocator get_allocator() const { return allocator; }                     // Копия распределителя (пул - общая арена)
+
     iterator begin();                                                         // Итератор на начало (неконстантный)
     iterator end();                                                           // Итератор на конец (неконстантный)
-    iterator begin() const;                                                   // Итератор на начало (константный)
-    iterator end() const;                                                     // Итератор на конец (константный)
+    const_iterator begin() const;                                             // Итератор на начало (константный)
+    const_iterator end() const;                                               // Итератор на конец (константный)
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    reverse_iterator rbegin() { return reverse_iterator(end()); }             // Максимальный элемент за O(1)
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+    const_reverse_iterator crbegin() const { return rbegin(); }
+    const_reverse_iterator crend() const { return rend(); }
 
     void push(const T& value);                                                // Добавление элемента
-    bool remove(const T& value);                                              // Удаление элемента
+
+    // Замена содержимого диапазоном, строго возрастающим по компаратору дерева,
+    // сборка за O(n). Нарушенный порядок или эквивалентные соседи - ошибка
+    // вызывающего: assert в отладочной сборке, std::invalid_argument в релизной
+    // (дерево при этом не меняется). Диапазон не должен ссылаться на элементы
+    // самого дерева; для произвольных данных есть bulk_insert
+    template<typename ForwardIterator>
+    void assign_sorted(ForwardIterator first, ForwardIterator last);
+
+    // Добавление неотсортированной пачки: сортировка пачки и слияние с деревом
+    template<typename InputIterator>
+    void bulk_insert(InputIterator first, InputIterator last);
+    bool remove(const T& value);                                              // Удаление элемента за O(log n)
+    size_t erase(const T& value);                                             // Удаление по ключу (0 или 1 элемент)
+    template<typename Key, typename KeyCompare>                               // Гетерогенное удаление по ключу
+    size_t erase(const Key& key, KeyCompare keyComp);
+    iterator erase(const_iterator position);                                  // Удаление по итератору, возврат следующего
+    iterator erase(iterator position) { return erase(const_iterator(position)); }
+
+    // Извлечение узла без освобождения памяти; insert(node_type&&) подвешивает
+    // его без новых выделений, если деревья делят распределитель (дерево
+    // построено от get_allocator() другого), иначе копирует значение
+    node_type extract(const_iterator position);
+    node_type extract(const T& value);                                        // Пустой дескриптор, если ключа нет
+    template<typename Key, typename KeyCompare>
+    node_type extract(const Key& key, KeyCompare keyComp);
+    insert_return_type insert(node_type&& handle);                            // Вставка извлеченного узла
     void clear();                                                             // Очистка дерева
     bool empty() const;                                                       // Проверка пустоты дерева
-    size_t size() const;                                                      // Получение размера дерева
+    size_t size() const;                                                      // Получение размера дерева за O(1)
+
+    const_iterator nth(size_t index) const;                                   // Элемент с порядковым номером index (с нуля)
+    size_t rank(const T& value) const;                                        // Количество элементов меньше value
+    template<typename Key, typename KeyCompare>                               // Гетерогенный вариант rank
+    size_t rank(const Key& key, KeyCompare keyComp) const;
+
+    iterator find(const T& value);                                            // Поиск по ключу за O(log n) (неконстантный)
+    const_iterator find(const T& value) const;                                // Поиск по ключу за O(log n) (константный)
+    bool contains(const T& value) const;                                      // Проверка наличия по ключу
+
+    // Гетерогенный поиск: keyComp должен уметь сравнивать (T, Key) и (Key, T)
+    // согласованно с компаратором дерева, например искать аптеку по строковому ID
+    template<typename Key, typename KeyCompare>
+    const_iterator find(const Key& key, KeyCompare keyComp) const;
+    template<typename Key, typename KeyCompare>
+    bool contains(const Key& key, KeyCompare keyComp) const;
+
+    const_iterator lower_bound(const T& value) const;                         // Первый элемент не меньше value
+    const_iterator upper_bound(const T& value) const;                         // Первый элемент больше value
+    std::pair<const_iterator, const_iterator> equal_range(const T& value) const; // Диапазон элементов, эквивалентных value
+    template<typename Key, typename KeyCompare>                               // Гетерогенный lower_bound
+    const_iterator lower_bound(const Key& key, KeyCompare keyComp) const;
+    template<typename Key, typename KeyCompare>                               // Гетерогенный upper_bound
+    const_iterator upper_bound(const Key& key, KeyCompare keyComp) const;
+    template<typename Key, typename KeyCompare>                               // Гетерогенный equal_range
+    std::pair<const_iterator, const_iterator> equal_range(const Key& key, KeyCompare keyComp) const;
+    template<typename Function>                                               // fn для элементов из [low, high] по возрастанию
+    void for_each_in_range(const T& low, const T& high, Function fn) const;   // за O(log n + k)
+    template<typename Key, typename KeyCompare, typename Function>            // Гетерогенный for_each_in_range
+    void for_each_in_range(const Key& low, const Key& high, KeyCompare keyComp, Function fn) const;
 
     template<typename Predicate>                                              // Поиск по условию (неконстантный)
     iterator find_if(Predicate pred);
     template<typename Predicate>                                              // Поиск по условию (константный)
-    iterator find_if(Predicate pred) const;
+    const_iterator find_if(Predicate pred) const;
 
     void printTree() const;                                                   // Вывод дерева на экран
 
 private:
-    treeNode<T>* insert(treeNode<T>* node, treeNode<T>* parent, const T& value); // Рекурсивное добавление
-    treeNode<T>* findMinNode(treeNode<T>* node) const;                        // Поиск минимального узла
-    void clearRecursive(treeNode<T>* node);                                   // Рекурсивная очистка
-    size_t sizeRecursive(treeNode<T>* node) const;                            // Рекурсивный подсчет размера
+    static treeNode<T>* findMinNode(treeNode<T>* node);                       // Поиск минимального узла
+    static treeNode<T>* findMaxNode(treeNode<T>* node);                       // Поиск максимального узла
+    void resetBounds();                                                       // Пересчет leftmost/rightmost по корню
+    void eraseNode(treeNode<T>* node);                                        // Удаление узла с балансировкой
+    void unlinkNode(treeNode<T>* node);                                       // Исключение узла без освобождения памяти
+    treeNode<T>* insertParent(const T& value, bool& goLeft,                   // Родитель для вставки (existing - эквивалент)
+                              treeNode<T>*& existing) const;
+    void linkNode(treeNode<T>* node, treeNode<T>* parent, bool goLeft);       // Подвешивание узла с балансировкой
+
+    treeNode<T>* createNode(const T& value);                                  // Выделение и конструирование узла
+    void destroyNode(treeNode<T>* node);                                      // Разрушение узла и возврат памяти
+
+    template<typename Key, typename KeyCompare>                               // Спуск по компаратору к узлу с ключом
+    treeNode<T>* findNode(const Key& key, KeyCompare keyComp) const;
+    template<typename Key, typename KeyCompare>                               // Первый узел не меньше ключа
+    treeNode<T>* lowerBoundNode(const Key& key, KeyCompare keyComp) const;
+    template<typename Key, typename KeyCompare>                               // Первый узел больше ключа
+    treeNode<T>* upperBoundNode(const Key& key, KeyCompare keyComp) const;
+
+    static bool isRed(const treeNode<T>* node);                               // Проверка красного цвета (nullptr - черный)
+    void rotateLeft(treeNode<T>* node);                                       // Левый поворот
+    void rotateRight(treeNode<T>* node);                                      // Правый поворот
+    void transplant(treeNode<T>* oldNode, treeNode<T>* newNode);              // Замена поддерева у родителя
+    void fixAfterInsert(treeNode<T>* node);                                   // Восстановление свойств после вставки
+    void fixAfterRemove(treeNode<T>* node, treeNode<T>* parent);              // Восстановление свойств после удаления
+    static treeNode<T>* nextNode(treeNode<T>* node);                          // Следующий узел при симметричном обходе
+    static treeNode<T>* prevNode(treeNode<T>* node);                          // Предыдущий узел при симметричном обходе
+    void clearNodes(treeNode<T>* node);                                       // Итеративная очистка поддерева
+    treeNode<T>* copyNodes(const treeNode<T>* source);                        // Итеративное копирование структуры поддерева
 
-    template<typename Predicate>                                              // Рекурсивный поиск по условию
-    treeNode<T>* findIfRecursive(treeNode<T>* node, Predicate pred) const;
+    template<typename ForwardIterator>                                        // Сборка сбалансированного поддерева из [lo, hi)
+    treeNode<T>* buildBalanced(const std::vector<ForwardIterator>& items, size_t lo, size_t hi,
+                               treeNode<T>* parent, size_t depth, size_t redDepth);
+    static size_t countOf(const treeNode<T>* node);                           // Размер поддерева (0 для nullptr)
+    static void updateCount(treeNode<T>* node);                               // Пересчет размера по потомкам
 
-    void printRecursive(treeNode<T>* node, int depth = 0) const;              // Рекурсивный вывод
+    template<typename Predicate>
+    treeNode<T>* findIfNode(Predicate pred) const;                            // Итеративный поиск по условию
+
+    void printNodes(treeNode<T>* node) const;                                 // Итеративный вывод
 };
 
-template <typename T>
-binaryTree<T>::binaryTree() : root(nullptr),
-    comparator([](const T& a, const T& b) { return a < b; })                  // Компаратор по умолчанию (оператор <)
+template <typename T, typename Compare, typename Allocator>
+binaryTree<T, Compare, Allocator>::binaryTree() : root(nullptr), leftmost(nullptr), rightmost(nullptr), nodeCount(0),
+    comparator()                                                              // Компаратор по умолчанию (std::less)
 {
 }
 
-template <typename T>
-binaryTree<T>::binaryTree(std::function<bool(const T&, const T&)> comp)
-    : root(nullptr), comparator(comp)                                         // Инициализация компаратора
+template <typename T, typename Compare, typename Allocator>
+binaryTree<T, Compare, Allocator>::binaryTree(const Compare& comp)
+    : root(nullptr), leftmost(nullptr), rightmost(nullptr), nodeCount(0),
+    comparator(comp)                                                          // Инициализация компаратора
 {
 }
 
-template <typename T>
-binaryTree<T>::~binaryTree()
+template <typename T, typename Compare, typename Allocator>
+binaryTree<T, Compare, Allocator>::binaryTree(const Allocator& alloc)
+    : root(nullptr), leftmost(nullptr), rightmost(nullptr), allocator(alloc), nodeCount(0),
+    comparator()
 {
-    clear();                                                                  // Очистка дерева при уничтожении
 }
 
-template <typename T>
-typename binaryTree<T>::iterator binaryTree<T>::begin()
+template <typename T, typename Compare, typename Allocator>
+binaryTree<T, Compare, Allocator>::binaryTree(const Compare& comp, const Allocator& alloc)
+    : root(nullptr), leftmost(nullptr), rightmost(nullptr), allocator(alloc), nodeCount(0),
+    comparator(comp)                                                          // Копия пула разделяет его арену
 {
-    treeNode<T>* leftmost = root;                                             // Начало с корня
-    if (leftmost != nullptr)                                                  // Если дерево не пустое
+}
+
+template <typename T, typename Compare, typename Allocator>
+template<typename ForwardIterator>
+binaryTree<T, Compare, Allocator>::binaryTree(ForwardIterator first, ForwardIterator last)
+    : binaryTree()
+{
+    assign_sorted(first, last);                                               // Сборка сбалансированного дерева
+}
+
+template <typename T, typename Compare, typename Allocator>
+template<typename ForwardIterator>
+binaryTree<T, Compare, Allocator>::binaryTree(ForwardIterator first, ForwardIterator last,
+                                     const Compare& comp)
+    : binaryTree(comp)
+{
+    assign_sorted(first, last);                                               // Сборка сбалансированного дерева
+}
+
+template <typename T, typename Compare, typename Allocator>
+binaryTree<T, Compare, Allocator>::binaryTree(const binaryTree& other)
+    : root(nullptr), leftmost(nullptr), rightmost(nullptr), allocator(), nodeCount(0),
+    comparator(other.comparator)                                              // Копия получает собственный пул узлов
+{
+    root = copyNodes(other.root);                                             // Повторение структуры без перевставок
+    nodeCount = other.nodeCount;
+    resetBounds();
+}
+
+template <typename T, typename Compare, typename Allocator>
+binaryTree<T, Compare, Allocator>::binaryTree(binaryTree&& other)
+    noexcept(std::is_nothrow_copy_constructible<Compare>::value)
+    : root(other.root), leftmost(other.leftmost), rightmost(other.rightmost),
+    allocator(std::move(other.allocator)),                                    // Узлы и их арена забираются целиком
+    nodeCount(other.nodeCount), comparator(other.comparator)
+{
+    other.root = nullptr;                                                     // Исходное дерево остается пустым
+    other.leftmost = nullptr;
+    other.rightmost = nullptr;
+    other.nodeCount = 0;
+}
+
+template <typename T, typename Compare, typename Allocator>
+binaryTree<T, Compare, Allocator>& binaryTree<T, Compare, Allocator>::operator=(const binaryTree& other)
+{
+    if (this != &other)                                                       // Проверка самоприсваивания
     {
-        while (leftmost->left != nullptr)                                     // Поиск самого левого узла
-            leftmost = leftmost->left;
+        binaryTree copy(other);                                               // Копия строится до изменения текущего дерева
+        swap(copy);                                                           // Старые узлы уходят вместе с копией
     }
-    return iterator(leftmost, root);                                          // Возврат итератора на начало
+    return *this;
 }
 
-template <typename T>
-typename binaryTree<T>::iterator binaryTree<T>::end()
+template <typename T, typename Compare, typename Allocator>
+binaryTree<T, Compare, Allocator>& binaryTree<T, Compare, Allocator>::operator=(binaryTree&& other) noexcept
 {
-    return iterator(nullptr, root);                                           // Итератор на конец (nullptr)
+    if (this != &other)                                                       // Проверка самоприсваивания
+    {
+        clear();                                                              // Освобождение собственных узлов
+        swap(other);                                                          // Забираем узлы, отдаем пустое дерево
+    }
+    return *this;
 }
 
-template <typename T>
-typename binaryTree<T>::iterator binaryTree<T>::begin() const
+template <typename T, typename Compare, typename Allocator>
+void binaryTree<T, Compare, Allocator>::swap(binaryTree& other) noexcept
+{
+    std::swap(root, other.root);                                              // Обмен корнями
+    std::swap(leftmost, other.leftmost);
+    std::swap(rightmost, other.rightmost);
+    std::swap(allocator, other.allocator);                                    // Узлы меняются вместе с аренами
+    std::swap(nodeCount, other.nodeCount);
+    std::swap(comparator, other.comparator);
+}
+
+template <typename T, typename Compare, typename Allocator>
+binaryTree<T, Compare, Allocator>::~binaryTree()
+{
+    clear();                                                                  // Очистка дерева при уничтожении
+}
+
+template <typename T, typename Compare, typename Allocator>
+typename binaryTree<T, Compare, Allocator>::iterator binaryTree<T, Compare, Allocator>::begin()
+{
+    return iterator(leftmost, this);                                          // Минимальный узел хранится в дереве
+}
+
+template <typename T, typename Compare, typename Allocator>
+typename binaryTree<T, Compare, Allocator>::iterator binaryTree<T, Compare, Allocator>::end()
+{
+    return iterator(nullptr, this);                                           // Итератор на конец (nullptr)
+}
+
+template <typename T, typename Compare, typename Allocator>
+typename binaryTree<T, Compare, Allocator>::const_iterator binaryTree<T, Compare, Allocator>::begin() const
+{
+    return const_iterator(leftmost, this);                                    // Минимальный узел хранится в дереве
+}
+
+template <typename T, typename Compare, typename Allocator>
+typename binaryTree<T, Compare, Allocator>::const_iterator binaryTree<T, Compare, Allocator>::end() const
+{
+    return const_iterator(nullptr, this);                                     // Итератор на конец (nullptr)
+}
+
+template <typename T, typename Compare, typename Allocator>
+void binaryTree<T, Compare, Allocator>::push(const T& value)
 {
-    treeNode<T>* leftmost = root;                                             // Начало с корня (константный)
-    if (leftmost != nullptr)                                                  // Если дерево не пустое
+    bool goLeft = false;                                                      // Направление последнего шага
+    treeNode<T>* existing = nullptr;                                          // Эквивалентный узел, если есть
+    treeNode<T>* parent = insertParent(value, goLeft, existing);              // Поиск места для вставки
+
+    if (existing != nullptr)                                                  // Равный элемент уже есть
+        return;                                                               // Дубликаты не добавляются
+
+    linkNode(createNode(value), parent, goLeft);                              // Создание нового (красного) узла
+}
+
+template <typename T, typename Compare, typename Allocator>
+treeNode<T>* binaryTree<T, Compare, Allocator>::insertParent(const T& value, bool& goLeft,
+                                                             treeNode<T>*& existing) const
+{
+    treeNode<T>* parent = nullptr;                                            // Родитель будущего узла
+    treeNode<T>* current = root;                                              // Спуск начинается с корня
+
+    while (current != nullptr)                                                // Поиск места для вставки
     {
-        while (leftmost->left != nullptr)                                     // Поиск самого левого узла
-            leftmost = leftmost->left;
+        parent = current;
+        if (comparator(value, current->data))                                 // Если значение меньше текущего
+        {
+            current = current->left;                                          // Переход в левое поддерево
+            goLeft = true;
+        }
+        else if (comparator(current->data, value))                            // Если значение больше текущего
+        {
+            current = current->right;                                         // Переход в правое поддерево
+            goLeft = false;
+        }
+        else                                                                  // Равный элемент уже есть
+        {
+            existing = current;
+            return nullptr;
+        }
     }
-    return iterator(leftmost, root);                                          // Возврат итератора на начало
+    return parent;
 }
 
-template <typename T>
-typename binaryTree<T>::iterator binaryTree<T>::end() const
+template <typename T, typename Compare, typename Allocator>
+void binaryTree<T, Compare, Allocator>::linkNode(treeNode<T>* newNode, treeNode<T>* parent, bool goLeft)
 {
-    return iterator(nullptr, root);                                           // Итератор на конец (nullptr)
+    newNode->left = newNode->right = nullptr;                                 // Узел мог прийти из другого дерева
+    newNode->color = nodeColor::RED;
+    newNode->count = 1;
+    newNode->parent = parent;                                                 // Установка родителя
+
+    if (parent == nullptr)                                                    // Если дерево было пустым
+        root = newNode;                                                       // Новый узел становится корнем
+    else if (goLeft)                                                          // Вставка левым потомком
+        parent->left = newNode;
+    else                                                                      // Вставка правым потомком
+        parent->right = newNode;
+
+    if (parent == nullptr || (goLeft && parent == leftmost))                  // Новый минимум
+        leftmost = newNode;
+    if (parent == nullptr || (!goLeft && parent == rightmost))                // Новый максимум
+        rightmost = newNode;
+
+    for (treeNode<T>* node = parent; node != nullptr; node = node->parent)    // Увеличение размеров поддеревьев на пути
+        ++node->count;
+    ++nodeCount;
+
+    fixAfterInsert(newNode);                                                  // Балансировка после вставки
 }
 
-template <typename T>
-void binaryTree<T>::push(const T& value)
+template <typename T, typename Compare, typename Allocator>
+template<typename ForwardIterator>
+void binaryTree<T, Compare, Allocator>::assign_sorted(ForwardIterator first, ForwardIterator last)
 {
-    if (root == nullptr)                                                      // Если дерево пустое
+    std::vector<ForwardIterator> items;                                       // Элементы диапазона по порядку
+    for (; first != last; ++first)
     {
-        root = new treeNode<T>(value);                                        // Создание корневого узла
+        if (!items.empty() && !comparator(*items.back(), *first))             // Эквивалент предыдущего или нарушен порядок
+        {
+            assert(!"assign_sorted: range is not strictly increasing");
+            throw std::invalid_argument("assign_sorted: range is not strictly increasing");
+        }
+        items.push_back(first);
     }
-    else                                                                      // Если дерево не пустое
+
+    clear();                                                                  // Старое содержимое больше не нужно
+    if (items.empty()) return;
+
+    size_t redDepth = 0;                                                      // Глубина нижнего (неполного) уровня
+    while ((size_t(2) << redDepth) <= items.size())                           // floor(log2(n))
+        ++redDepth;
+
+    try
     {
-        root = insert(root, nullptr, value);                                  // Рекурсивное добавление
+        root = buildBalanced(items, 0, items.size(), nullptr, 0, redDepth);
     }
+    catch (...)
+    {
+        clearNodes(root);                                                     // Откат частично собранного дерева
+        root = nullptr;
+        throw;
+    }
+    nodeCount = items.size();
+    resetBounds();
 }
 
-template <typename T>
-treeNode<T>* binaryTree<T>::insert(treeNode<T>* node, treeNode<T>* parent, const T& value)
+template <typename T, typename Compare, typename Allocator>
+template<typename ForwardIterator>
+treeNode<T>* binaryTree<T, Compare, Allocator>::buildBalanced(const std::vector<ForwardIterator>& items, size_t lo, size_t hi,
+                                                     treeNode<T>* parent, size_t depth, size_t redDepth)
 {
-    if (node == nullptr)                                                      // Если достигли места для вставки
+    if (lo >= hi) return nullptr;
+
+    size_t mid = lo + (hi - lo) / 2;                                          // Середина становится корнем поддерева
+    treeNode<T>* node = createNode(*items[mid]);
+    node->parent = parent;
+    node->count = hi - lo;
+    node->color = (depth == redDepth && depth > 0) ? nodeColor::RED           // Все уровни, кроме нижнего, полные:
+                                                   : nodeColor::BLACK;        // нижний красный, остальные черные
+    if (parent == nullptr)
+        root = node;                                                          // Корень виден сразу - для отката при исключении
+
+    // Глубина рекурсии ограничена log2(n)
+    node->left = buildBalanced(items, lo, mid, node, depth + 1, redDepth);
+    node->right = buildBalanced(items, mid + 1, hi, node, depth + 1, redDepth);
+    return node;
+}
+
+template <typename T, typename Compare, typename Allocator>
+template<typename InputIterator>
+void binaryTree<T, Compare, Allocator>::bulk_insert(InputIterator first, InputIterator last)
+{
+    std::vector<T> batch(first, last);                                        // Копия пачки для сортировки
+    if (batch.empty()) return;
+
+    size_t height = 1;                                                        // Оценка log2(n + m)
+    while ((size_t(1) << height) <= nodeCount + batch.size())
+        ++height;
+
+    if (batch.size() * height < nodeCount)                                    // Малая пачка: вставки по одной дешевле
     {
-        treeNode<T>* newNode = new treeNode<T>(value);                        // Создание нового узла
-        newNode->parent = parent;                                             // Установка родителя
-        return newNode;                                                       // Возврат нового узла
+        for (const auto& value : batch)
+            push(value);
+        return;
     }
 
-    if (comparator(value, node->data))                                        // Если значение меньше текущего
+    std::stable_sort(batch.begin(), batch.end(), comparator);                 // Из эквивалентных остается первый
+    batch.erase(std::unique(batch.begin(), batch.end(),                       // assign_sorted требует уникальных элементов
+                            [this](const T& a, const T& b) { return !comparator(a, b); }),
+                batch.end());
+
+    std::vector<T> merged;                                                    // Слияние с содержимым дерева
+    merged.reserve(nodeCount + batch.size());
+    auto it = batch.begin();
+    for (treeNode<T>* node = leftmost; node != nullptr; node = nextNode(node))
     {
-        node->left = insert(node->left, node, value);                         // Рекурсивный вызов для левого поддерева
+        for (; it != batch.end() && comparator(*it, node->data); ++it)        // Элементы пачки меньше узла
+            merged.push_back(*it);
+        for (; it != batch.end() && !comparator(node->data, *it); ++it)       // Эквиваленты узла пропускаются
+            ;
+        merged.push_back(node->data);                                         // Существующий элемент сохраняется
     }
-    else if (comparator(node->data, value))                                   // Если значение больше текущего
+    merged.insert(merged.end(), it, batch.end());                             // Хвост пачки
+
+    assign_sorted(merged.begin(), merged.end());                              // Пересборка за O(n + m)
+}
+
+template <typename T, typename Compare, typename Allocator>
+bool binaryTree<T, Compare, Allocator>::remove(const T& value)
+{
+    return erase(value) != 0;                                                 // Спуск по компаратору за O(log n)
+}
+
+template <typename T, typename Compare, typename Allocator>
+size_t binaryTree<T, Compare, Allocator>::erase(const T& value)
+{
+    return erase(value, comparator);
+}
+
+template <typename T, typename Compare, typename Allocator>
+template<typename Key, typename KeyCompare>
+size_t binaryTree<T, Compare, Allocator>::erase(const Key& key, KeyCompare keyComp)
+{
+    treeNode<T>* node = findNode(key, keyComp);                               // Поиск удаляемого узла
+    if (node == nullptr) return 0;                                            // Если элемент не найден
+
+    eraseNode(node);                                                          // Удаление с балансировкой
+    return 1;                                                                 // Ключи уникальны
+}
+
+template <typename T, typename Compare, typename Allocator>
+typename binaryTree<T, Compare, Allocator>::iterator binaryTree<T, Compare, Allocator>::erase(const_iterator position)
+{
+    treeNode<T>* node = position.getNode();
+    if (node == nullptr)                                                      // end() удалить нельзя
+        throw std::out_of_range("Cannot erase end iterator");
+
+    treeNode<T>* next = nextNode(node);                                       // Узлы при удалении не перемещаются
+    eraseNode(node);
+    return iterator(next, this);
+}
+
+template <typename T, typename Compare, typename Allocator>
+typename binaryTree<T, Compare, Allocator>::node_type binaryTree<T, Compare, Allocator>::extract(const_iterator position)
+{
+    treeNode<T>* node = position.getNode();
+    if (node == nullptr)                                                      // end() извлечь нельзя
+        throw std::out_of_range("Cannot extract end iterator");
+
+    unlinkNode(node);                                                         // Узел покидает дерево без освобождения
+    return node_type(node, allocator);
+}
+
+template <typename T, typename Compare, typename Allocator>
+typename binaryTree<T, Compare, Allocator>::node_type binaryTree<T, Compare, Allocator>::extract(const T& value)
+{
+    return extract(value, comparator);
+}
+
+template <typename T, typename Compare, typename Allocator>
+template<typename Key, typename KeyCompare>
+typename binaryTree<T, Compare, Allocator>::node_type binaryTree<T, Compare, Allocator>::extract(const Key& key,
+                                                                                                KeyCompare keyComp)
+{
+    treeNode<T>* node = findNode(key, keyComp);
+    if (node == nullptr) return node_type();                                  // Пустой дескриптор - ключа нет
+
+    unlinkNode(node);
+    return node_type(node, allocator);
+}
+
+template <typename T, typename Compare, typename Allocator>
+typename binaryTree<T, Compare, Allocator>::insert_return_type binaryTree<T, Compare, Allocator>::insert(node_type&& handle)
+{
+    if (handle.empty())                                                       // Нечего вставлять
+        return {end(), false, node_type()};
+
+    bool goLeft = false;
+    treeNode<T>* existing = nullptr;
+    treeNode<T>* parent = insertParent(handle.value(), goLeft, existing);
+    if (existing != nullptr)                                                  // Ключ занят - дескриптор возвращается
+        return {iterator(existing, this), false, std::move(handle)};
+
+    treeNode<T>* node = nullptr;
+    if (allocator == handle.allocator)                                        // Общая память - узел переносится как есть
+    {
+        node = handle.release();
+    }
+    else                                                                      // Иначе копия в своей памяти
     {
-        node->right = insert(node->right, node, value);                       // Рекурсивный вызов для правого поддерева
+        node = createNode(handle.value());
+        handle.reset();
     }
+    linkNode(node, parent, goLeft);
+    return {iterator(node, this), true, node_type()};
+}
 
-    return node;                                                              // Возврат текущего узла
+template <typename T, typename Compare, typename Allocator>
+void binaryTree<T, Compare, Allocator>::eraseNode(treeNode<T>* node)
+{
+    unlinkNode(node);                                                         // Исключение из дерева с балансировкой
+    destroyNode(node);                                                        // Удаление узла
 }
 
-template <typename T>
-bool binaryTree<T>::remove(const T& value)
+template <typename T, typename Compare, typename Allocator>
+void binaryTree<T, Compare, Allocator>::unlinkNode(treeNode<T>* node)
 {
-    auto it = find_if([&value](const T& item) {                               // Поиск элемента для удаления
-        return !(item < value) && !(value < item);                            // Проверка равенства
-    });
+    treeNode<T>* child = nullptr;                                             // Узел, встающий на место удаленного
+    treeNode<T>* childParent = nullptr;                                       // Родитель этого узла (child может быть nullptr)
+    nodeColor removedColor = node->color;                                     // Цвет фактически изъятого из дерева узла
 
-    if (it == end()) return false;                                            // Если элемент не найден
+    treeNode<T>* spliced = (node->left != nullptr && node->right != nullptr)  // Узел, чья позиция исчезает из дерева
+                               ? findMinNode(node->right) : node;
+    for (treeNode<T>* up = spliced->parent; up != nullptr; up = up->parent)   // Уменьшение размеров поддеревьев на пути
+        --up->count;
+    --nodeCount;
 
-    treeNode<T>* node = it.getNode();                                         // Получение узла для удаления
-    if (node == nullptr) return false;                                        // Проверка нулевого указателя
+    if (node == leftmost)                                                     // Границы сдвигаются к соседям
+        leftmost = nextNode(node);
+    if (node == rightmost)
+        rightmost = prevNode(node);
 
-    if (node->left == nullptr && node->right == nullptr)                      // Случай 1: узел без потомков
+    if (node->left == nullptr)                                                // Случай 1: нет левого потомка
     {
-        if (node->parent != nullptr)                                          // Если узел не корневой
+        child = node->right;
+        childParent = node->parent;
+        transplant(node, node->right);                                        // Замена узла правым поддеревом
+    }
+    else if (node->right == nullptr)                                          // Случай 2: нет правого потомка
+    {
+        child = node->left;
+        childParent = node->parent;
+        transplant(node, node->left);                                         // Замена узла левым поддеревом
+    }
+    else                                                                      // Случай 3: узел с двумя потомками
+    {
+        treeNode<T>* successor = spliced;                                     // Преемник (мин в правом поддереве)
+        removedColor = successor->color;                                      // Из дерева изымается позиция преемника
+        child = successor->right;
+
+        if (successor->parent == node)                                        // Если преемник - прямой потомок
         {
-            if (node->parent->left == node)                                   // Если узел - левый потомок
-                node->parent->left = nullptr;                                 // Обнуление указателя у родителя
-            else                                                              // Если узел - правый потомок
-                node->parent->right = nullptr;                                // Обнуление указателя у родителя
+            childParent = successor;
         }
-        else                                                                  // Если узел корневой
+        else                                                                  // Если преемник глубже
         {
-            root = nullptr;                                                   // Обнуление корня
+            childParent = successor->parent;
+            transplant(successor, successor->right);                          // Вынимаем преемника
+            successor->right = node->right;                                   // Преемник забирает правое поддерево
+            successor->right->parent = successor;
         }
-        delete node;                                                          // Удаление узла
+
+        transplant(node, successor);                                          // Преемник встает на место узла
+        successor->left = node->left;                                         // и забирает левое поддерево
+        successor->left->parent = successor;
+        successor->color = node->color;                                       // Цвет позиции сохраняется
+        successor->count = node->count;                                       // и размер поддерева (уже уменьшенный)
     }
-    else if (node->left == nullptr || node->right == nullptr)                 // Случай 2: узел с одним потомком
+
+    node->left = node->right = node->parent = nullptr;                        // Узел больше не связан с деревом
+
+    if (removedColor == nodeColor::BLACK)                                     // Удален черный узел - нарушена черная высота
+        fixAfterRemove(child, childParent);
+}
+
+template <typename T, typename Compare, typename Allocator>
+treeNode<T>* binaryTree<T, Compare, Allocator>::createNode(const T& value)
+{
+    treeNode<T>* node = allocator.allocate();                                 // Память из распределителя
+    try
     {
-        treeNode<T>* child = (node->left != nullptr) ? node->left : node->right;  // Определение единственного потомка
-        child->parent = node->parent;                                         // Установка родителя у потомка
+        new (node) treeNode<T>(value);                                        // Конструирование узла на месте
+    }
+    catch (...)
+    {
+        allocator.deallocate(node);                                           // Возврат памяти при исключении
+        throw;
+    }
+    return node;
+}
+
+template <typename T, typename Compare, typename Allocator>
+void binaryTree<T, Compare, Allocator>::destroyNode(treeNode<T>* node)
+{
+    node->~treeNode<T>();                                                     // Явный вызов деструктора
+    allocator.deallocate(node);                                               // Возврат памяти распределителю
+}
 
-        if (node->parent != nullptr)                                          // Если узел не корневой
+template <typename T, typename Compare, typename Allocator>
+bool binaryTree<T, Compare, Allocator>::isRed(const treeNode<T>* node)
+{
+    return node != nullptr && node->color == nodeColor::RED;                  // Пустые листья считаются черными
+}
+
+template <typename T, typename Compare, typename Allocator>
+void binaryTree<T, Compare, Allocator>::rotateLeft(treeNode<T>* node)
+{
+    treeNode<T>* pivot = node->right;                                         // Правый потомок поднимается вверх
+    node->right = pivot->left;                                                // Левое поддерево опоры переходит к узлу
+    if (pivot->left != nullptr)
+        pivot->left->parent = node;
+
+    transplant(node, pivot);                                                  // Опора занимает место узла
+    pivot->left = node;                                                       // Узел становится левым потомком опоры
+    node->parent = pivot;
+
+    pivot->count = node->count;                                               // Опора наследует размер поддерева
+    updateCount(node);                                                        // Размер узла пересчитывается по потомкам
+}
+
+template <typename T, typename Compare, typename Allocator>
+void binaryTree<T, Compare, Allocator>::rotateRight(treeNode<T>* node)
+{
+    treeNode<T>* pivot = node->left;                                          // Левый потомок поднимается вверх
+    node->left = pivot->right;                                                // Правое поддерево опоры переходит к узлу
+    if (pivot->right != nullptr)
+        pivot->right->parent = node;
+
+    transplant(node, pivot);                                                  // Опора занимает место узла
+    pivot->right = node;                                                      // Узел становится правым потомком опоры
+    node->parent = pivot;
+
+    pivot->count = node->count;                                               // Опора наследует размер поддерева
+    updateCount(node);                                                        // Размер узла пересчитывается по потомкам
+}
+
+template <typename T, typename Compare, typename Allocator>
+void binaryTree<T, Compare, Allocator>::transplant(treeNode<T>* oldNode, treeNode<T>* newNode)
+{
+    if (oldNode->parent == nullptr)                                           // Если заменяется корень
+        root = newNode;
+    else if (oldNode == oldNode->parent->left)                                // Если заменяется левый потомок
+        oldNode->parent->left = newNode;
+    else                                                                      // Если заменяется правый потомок
+        oldNode->parent->right = newNode;
+
+    if (newNode != nullptr)                                                   // Обновление родителя нового поддерева
+        newNode->parent = oldNode->parent;
+}
+
+template <typename T, typename Compare, typename Allocator>
+void binaryTree<T, Compare, Allocator>::fixAfterInsert(treeNode<T>* node)
+{
+    while (node != root && isRed(node->parent))                               // Два красных узла подряд
+    {
+        treeNode<T>* parent = node->parent;
+        treeNode<T>* grandparent = parent->parent;                            // Существует: красный узел не бывает корнем
+
+        if (parent == grandparent->left)                                      // Родитель - левый потомок
         {
-            if (node->parent->left == node)                                   // Если узел - левый потомок
-                node->parent->left = child;                                   // Замена на потомка
-            else                                                              // Если узел - правый потомок
-                node->parent->right = child;                                  // Замена на потомка
+            treeNode<T>* uncle = grandparent->right;
+            if (isRed(uncle))                                                 // Красный дядя - перекрашивание
+            {
+                parent->color = nodeColor::BLACK;
+                uncle->color = nodeColor::BLACK;
+                grandparent->color = nodeColor::RED;
+                node = grandparent;                                           // Проблема поднимается выше
+            }
+            else                                                              // Черный дядя - повороты
+            {
+                if (node == parent->right)                                    // Излом сводится к прямой линии
+                {
+                    node = parent;
+                    rotateLeft(node);
+                    parent = node->parent;
+                }
+                parent->color = nodeColor::BLACK;
+                grandparent->color = nodeColor::RED;
+                rotateRight(grandparent);
+            }
         }
-        else                                                                  // Если узел корневой
+        else                                                                  // Зеркальный случай
         {
-            root = child;                                                     // Установка потомка как корня
+            treeNode<T>* uncle = grandparent->left;
+            if (isRed(uncle))
+            {
+                parent->color = nodeColor::BLACK;
+                uncle->color = nodeColor::BLACK;
+                grandparent->color = nodeColor::RED;
+                node = grandparent;
+            }
+            else
+            {
+                if (node == parent->left)
+                {
+                    node = parent;
+                    rotateRight(node);
+                    parent = node->parent;
+                }
+                parent->color = nodeColor::BLACK;
+                grandparent->color = nodeColor::RED;
+                rotateLeft(grandparent);
+            }
         }
-        delete node;                                                          // Удаление узла
     }
-    else                                                                      // Случай 3: узел с двумя потомками
-    {
-        treeNode<T>* successor = findMinNode(node->right);                    // Поиск преемника (мин в правом поддереве)
-        node->data = successor->data;                                         // Копирование данных преемника
 
-        if (successor->parent->left == successor)                             // Если преемник - левый потомок
-            successor->parent->left = successor->right;                       // Замена на правого потомка преемника
-        else                                                                  // Если преемник - правый потомок
-            successor->parent->right = successor->right;                      // Замена на правого потомка преемника
+    root->color = nodeColor::BLACK;                                           // Корень всегда черный
+}
 
-        if (successor->right != nullptr)                                      // Если у преемника есть правый потомок
-            successor->right->parent = successor->parent;                     // Обновление родителя
+template <typename T, typename Compare, typename Allocator>
+void binaryTree<T, Compare, Allocator>::fixAfterRemove(treeNode<T>* node, treeNode<T>* parent)
+{
+    while (node != root && !isRed(node))                                      // Узел несет "лишний" черный цвет
+    {
+        if (node == parent->left)                                             // Узел - левый потомок
+        {
+            treeNode<T>* sibling = parent->right;                             // Брат существует по свойству черной высоты
+            if (isRed(sibling))                                               // Красный брат - сводим к черному
+            {
+                sibling->color = nodeColor::BLACK;
+                parent->color = nodeColor::RED;
+                rotateLeft(parent);
+                sibling = parent->right;
+            }
+
+            if (!isRed(sibling->left) && !isRed(sibling->right))              // Оба племянника черные
+            {
+                sibling->color = nodeColor::RED;
+                node = parent;                                                // Проблема поднимается выше
+                parent = node->parent;
+            }
+            else
+            {
+                if (!isRed(sibling->right))                                   // Красный только ближний племянник
+                {
+                    sibling->left->color = nodeColor::BLACK;
+                    sibling->color = nodeColor::RED;
+                    rotateRight(sibling);
+                    sibling = parent->right;
+                }
+                sibling->color = parent->color;                               // Дальний племянник красный - финальный поворот
+                parent->color = nodeColor::BLACK;
+                sibling->right->color = nodeColor::BLACK;
+                rotateLeft(parent);
+                node = root;
+            }
+        }
+        else                                                                  // Зеркальный случай
+        {
+            treeNode<T>* sibling = parent->left;
+            if (isRed(sibling))
+            {
+                sibling->color = nodeColor::BLACK;
+                parent->color = nodeColor::RED;
+                rotateRight(parent);
+                sibling = parent->left;
+            }
 
-        delete successor;                                                     // Удаление преемника
+            if (!isRed(sibling->left) && !isRed(sibling->right))
+            {
+                sibling->color = nodeColor::RED;
+                node = parent;
+                parent = node->parent;
+            }
+            else
+            {
+                if (!isRed(sibling->left))
+                {
+                    sibling->right->color = nodeColor::BLACK;
+                    sibling->color = nodeColor::RED;
+                    rotateLeft(sibling);
+                    sibling = parent->left;
+                }
+                sibling->color = parent->color;
+                parent->color = nodeColor::BLACK;
+                sibling->left->color = nodeColor::BLACK;
+                rotateRight(parent);
+                node = root;
+            }
+        }
     }
 
-    return true;                                                              // Удаление успешно
+    if (node != nullptr)                                                      // Поглощение лишнего черного
+        node->color = nodeColor::BLACK;
 }
 
-template <typename T>
-treeNode<T>* binaryTree<T>::findMinNode(treeNode<T>* node) const
+template <typename T, typename Compare, typename Allocator>
+treeNode<T>* binaryTree<T, Compare, Allocator>::findMinNode(treeNode<T>* node)
 {
     while (node != nullptr && node->left != nullptr)                          // Пока есть левый потомок
         node = node->left;                                                    // Движение влево
     return node;                                                              // Возврат минимального узла
 }
 
-template <typename T>
-void binaryTree<T>::clear()
+template <typename T, typename Compare, typename Allocator>
+treeNode<T>* binaryTree<T, Compare, Allocator>::findMaxNode(treeNode<T>* node)
+{
+    while (node != nullptr && node->right != nullptr)                         // Пока есть правый потомок
+        node = node->right;                                                   // Движение вправо
+    return node;                                                              // Возврат максимального узла
+}
+
+template <typename T, typename Compare, typename Allocator>
+void binaryTree<T, Compare, Allocator>::resetBounds()
 {
-    clearRecursive(root);                                                     // Рекурсивная очистка
+    leftmost = findMinNode(root);                                             // O(log n) после массовых изменений
+    rightmost = findMaxNode(root);
+}
+
+template <typename T, typename Compare, typename Allocator>
+void binaryTree<T, Compare, Allocator>::clear()
+{
+    if (std::is_trivially_destructible<T>::value && allocator.release())      // Деструкторы не нужны - арена целиком за O(1)
+    {
+        root = leftmost = rightmost = nullptr;
+        nodeCount = 0;
+        return;
+    }
+
+    clearNodes(root);                                                         // Итеративная очистка
+    allocator.release();                                                      // Возврат блоков арены, если она не разделена
     root = nullptr;                                                           // Обнуление корня
+    leftmost = rightmost = nullptr;
+    nodeCount = 0;                                                            // Сброс счетчика элементов
 }
 
-template <typename T>
-void binaryTree<T>::clearRecursive(treeNode<T>* node)
+template <typename T, typename Compare, typename Allocator>
+void binaryTree<T, Compare, Allocator>::clearNodes(treeNode<T>* node)
 {
-    if (node == nullptr) return;                                              // Базовый случай рекурсии
+    treeNode<T>* stop = node != nullptr ? node->parent : nullptr;             // Граница обхода - родитель поддерева
 
-    clearRecursive(node->left);                                               // Очистка левого поддерева
-    clearRecursive(node->right);                                              // Очистка правого поддерева
-    delete node;                                                              // Удаление текущего узла
+    while (node != nullptr && node != stop)                                   // Обратный обход по указателям на родителя
+    {
+        if (node->left != nullptr)                                            // Сначала спуск влево
+        {
+            node = node->left;
+        }
+        else if (node->right != nullptr)                                      // Затем вправо
+        {
+            node = node->right;
+        }
+        else                                                                  // Лист - удаляется, подъем к родителю
+        {
+            treeNode<T>* parent = node->parent;
+            if (parent != nullptr)                                            // Отцепление листа от родителя
+            {
+                if (parent->left == node)
+                    parent->left = nullptr;
+                else
+                    parent->right = nullptr;
+            }
+            destroyNode(node);                                                // Удаление текущего узла
+            node = parent;
+        }
+    }
 }
 
-template <typename T>
-bool binaryTree<T>::empty() const
+template <typename T, typename Compare, typename Allocator>
+treeNode<T>* binaryTree<T, Compare, Allocator>::copyNodes(const treeNode<T>* source)
+{
+    if (source == nullptr) return nullptr;
+
+    auto cloneNode = [this](const treeNode<T>* original) {                    // Копия узла с цветом и размером поддерева
+        treeNode<T>* node = createNode(original->data);
+        node->color = original->color;
+        node->count = original->count;
+        return node;
+    };
+
+    treeNode<T>* copyRoot = cloneNode(source);
+    const treeNode<T>* from = source;                                         // Текущий узел оригинала
+    treeNode<T>* to = copyRoot;                                               // Соответствующий узел копии
+
+    try
+    {
+        while (true)                                                          // Прямой обход по указателям на родителя
+        {
+            if (from->left != nullptr && to->left == nullptr)                 // Левое поддерево еще не скопировано
+            {
+                to->left = cloneNode(from->left);
+                to->left->parent = to;
+                from = from->left;
+                to = to->left;
+            }
+            else if (from->right != nullptr && to->right == nullptr)          // Правое поддерево еще не скопировано
+            {
+                to->right = cloneNode(from->right);
+                to->right->parent = to;
+                from = from->right;
+                to = to->right;
+            }
+            else if (from == source)                                          // Поддерево скопировано полностью
+            {
+                break;
+            }
+            else                                                              // Подъем к родителю
+            {
+                from = from->parent;
+                to = to->parent;
+            }
+        }
+    }
+    catch (...)
+    {
+        clearNodes(copyRoot);                                                 // Откат частично созданной копии
+        throw;
+    }
+
+    return copyRoot;
+}
+
+template <typename T, typename Compare, typename Allocator>
+bool binaryTree<T, Compare, Allocator>::empty() const
 {
     return root == nullptr;                                                   // Проверка пустого корня
 }
 
-template <typename T>
-size_t binaryTree<T>::size() const
+template <typename T, typename Compare, typename Allocator>
+size_t binaryTree<T, Compare, Allocator>::size() const
 {
-    return sizeRecursive(root);                                               // Рекурсивный подсчет размера
+    return nodeCount;                                                         // Счетчик поддерживается при изменениях
 }
 
-template <typename T>
-size_t binaryTree<T>::sizeRecursive(treeNode<T>* node) const
+template <typename T, typename Compare, typename Allocator>
+typename binaryTree<T, Compare, Allocator>::const_iterator binaryTree<T, Compare, Allocator>::nth(size_t index) const
+{
+    treeNode<T>* current = root;                                              // Спуск по размерам поддеревьев
+    while (current != nullptr)
+    {
+        size_t leftCount = countOf(current->left);
+        if (index < leftCount)                                                // Искомый элемент в левом поддереве
+        {
+            current = current->left;
+        }
+        else if (index == leftCount)                                          // Текущий узел и есть искомый
+        {
+            break;
+        }
+        else                                                                  // Искомый элемент в правом поддереве
+        {
+            index -= leftCount + 1;
+            current = current->right;
+        }
+    }
+    return const_iterator(current, this);                                     // end(), если index >= size()
+}
+
+template <typename T, typename Compare, typename Allocator>
+size_t binaryTree<T, Compare, Allocator>::rank(const T& value) const
 {
-    if (node == nullptr) return 0;                                            // Базовый случай рекурсии
-    return 1 + sizeRecursive(node->left) + sizeRecursive(node->right);        // 1 + размер левого + размер правого
+    return rank(value, comparator);                                           // Ранг по компаратору дерева
 }
 
-template <typename T>
+template <typename T, typename Compare, typename Allocator>
+template<typename Key, typename KeyCompare>
+size_t binaryTree<T, Compare, Allocator>::rank(const Key& key, KeyCompare keyComp) const
+{
+    size_t result = 0;
+    treeNode<T>* current = root;
+    while (current != nullptr)
+    {
+        if (keyComp(current->data, key))                                      // Узел и его левое поддерево меньше ключа
+        {
+            result += countOf(current->left) + 1;
+            current = current->right;
+        }
+        else                                                                  // Ключ не больше узла - идем влево
+        {
+            current = current->left;
+        }
+    }
+    return result;                                                            // Количество элементов меньше ключа
+}
+
+template <typename T, typename Compare, typename Allocator>
+size_t binaryTree<T, Compare, Allocator>::countOf(const treeNode<T>* node)
+{
+    return node != nullptr ? node->count : 0;
+}
+
+template <typename T, typename Compare, typename Allocator>
+void binaryTree<T, Compare, Allocator>::updateCount(treeNode<T>* node)
+{
+    node->count = 1 + countOf(node->left) + countOf(node->right);
+}
+
+template <typename T, typename Compare, typename Allocator>
+typename binaryTree<T, Compare, Allocator>::iterator binaryTree<T, Compare, Allocator>::find(const T& value)
+{
+    return iterator(findNode(value, comparator), this);                       // Спуск по компаратору дерева
+}
+
+template <typename T, typename Compare, typename Allocator>
+typename binaryTree<T, Compare, Allocator>::const_iterator binaryTree<T, Compare, Allocator>::find(const T& value) const
+{
+    return const_iterator(findNode(value, comparator), this);                 // Спуск по компаратору дерева (константный)
+}
+
+template <typename T, typename Compare, typename Allocator>
+bool binaryTree<T, Compare, Allocator>::contains(const T& value) const
+{
+    return findNode(value, comparator) != nullptr;                            // Элемент найден
+}
+
+template <typename T, typename Compare, typename Allocator>
+template<typename Key, typename KeyCompare>
+typename binaryTree<T, Compare, Allocator>::const_iterator binaryTree<T, Compare, Allocator>::find(const Key& key, KeyCompare keyComp) const
+{
+    return const_iterator(findNode(key, keyComp), this);                      // Гетерогенный спуск
+}
+
+template <typename T, typename Compare, typename Allocator>
+template<typename Key, typename KeyCompare>
+bool binaryTree<T, Compare, Allocator>::contains(const Key& key, KeyCompare keyComp) const
+{
+    return findNode(key, keyComp) != nullptr;                                 // Элемент с ключом найден
+}
+
+template <typename T, typename Compare, typename Allocator>
+template<typename Key, typename KeyCompare>
+treeNode<T>* binaryTree<T, Compare, Allocator>::findNode(const Key& key, KeyCompare keyComp) const
+{
+    treeNode<T>* current = root;                                              // Спуск начинается с корня
+    while (current != nullptr)
+    {
+        if (keyComp(key, current->data))                                      // Ключ меньше - идем влево
+            current = current->left;
+        else if (keyComp(current->data, key))                                 // Ключ больше - идем вправо
+            current = current->right;
+        else                                                                  // Ключ эквивалентен данным узла
+            return current;
+    }
+    return nullptr;                                                           // Ключ не найден
+}
+
+template <typename T, typename Compare, typename Allocator>
+typename binaryTree<T, Compare, Allocator>::const_iterator binaryTree<T, Compare, Allocator>::lower_bound(const T& value) const
+{
+    return const_iterator(lowerBoundNode(value, comparator), this);
+}
+
+template <typename T, typename Compare, typename Allocator>
+typename binaryTree<T, Compare, Allocator>::const_iterator binaryTree<T, Compare, Allocator>::upper_bound(const T& value) const
+{
+    return const_iterator(upperBoundNode(value, comparator), this);
+}
+
+template <typename T, typename Compare, typename Allocator>
+std::pair<typename binaryTree<T, Compare, Allocator>::const_iterator, typename binaryTree<T, Compare, Allocator>::const_iterator>
+binaryTree<T, Compare, Allocator>::equal_range(const T& value) const
+{
+    return equal_range(value, comparator);
+}
+
+template <typename T, typename Compare, typename Allocator>
+template<typename Key, typename KeyCompare>
+typename binaryTree<T, Compare, Allocator>::const_iterator binaryTree<T, Compare, Allocator>::lower_bound(const Key& key, KeyCompare keyComp) const
+{
+    return const_iterator(lowerBoundNode(key, keyComp), this);
+}
+
+template <typename T, typename Compare, typename Allocator>
+template<typename Key, typename KeyCompare>
+typename binaryTree<T, Compare, Allocator>::const_iterator binaryTree<T, Compare, Allocator>::upper_bound(const Key& key, KeyCompare keyComp) const
+{
+    return const_iterator(upperBoundNode(key, keyComp), this);
+}
+
+template <typename T, typename Compare, typename Allocator>
+template<typename Key, typename KeyCompare>
+std::pair<typename binaryTree<T, Compare, Allocator>::const_iterator, typename binaryTree<T, Compare, Allocator>::const_iterator>
+binaryTree<T, Compare, Allocator>::equal_range(const Key& key, KeyCompare keyComp) const
+{
+    return std::make_pair(const_iterator(lowerBoundNode(key, keyComp), this), // Ключи уникальны - не более одного элемента
+                          const_iterator(upperBoundNode(key, keyComp), this));
+}
+
+template <typename T, typename Compare, typename Allocator>
+template<typename Function>
+void binaryTree<T, Compare, Allocator>::for_each_in_range(const T& low, const T& high, Function fn) const
+{
+    for_each_in_range(low, high, comparator, fn);
+}
+
+template <typename T, typename Compare, typename Allocator>
+template<typename Key, typename KeyCompare, typename Function>
+void binaryTree<T, Compare, Allocator>::for_each_in_range(const Key& low, const Key& high, KeyCompare keyComp, Function fn) const
+{
+    for (treeNode<T>* node = lowerBoundNode(low, keyComp);                    // Спуск к началу отрезка за O(log n)
+         node != nullptr && !keyComp(high, node->data);                       // Пока элемент не больше верхней границы
+         node = nextNode(node))
+        fn(node->data);
+}
+
+template <typename T, typename Compare, typename Allocator>
+template<typename Key, typename KeyCompare>
+treeNode<T>* binaryTree<T, Compare, Allocator>::lowerBoundNode(const Key& key, KeyCompare keyComp) const
+{
+    treeNode<T>* result = nullptr;                                            // Лучший найденный кандидат
+    treeNode<T>* current = root;
+    while (current != nullptr)
+    {
+        if (keyComp(current->data, key))                                      // Узел меньше ключа - идем вправо
+        {
+            current = current->right;
+        }
+        else                                                                  // Узел подходит - ищем левее
+        {
+            result = current;
+            current = current->left;
+        }
+    }
+    return result;
+}
+
+template <typename T, typename Compare, typename Allocator>
+template<typename Key, typename KeyCompare>
+treeNode<T>* binaryTree<T, Compare, Allocator>::upperBoundNode(const Key& key, KeyCompare keyComp) const
+{
+    treeNode<T>* result = nullptr;                                            // Лучший найденный кандидат
+    treeNode<T>* current = root;
+    while (current != nullptr)
+    {
+        if (keyComp(key, current->data))                                      // Узел больше ключа - ищем левее
+        {
+            result = current;
+            current = current->left;
+        }
+        else                                                                  // Узел не больше ключа - идем вправо
+        {
+            current = current->right;
+        }
+    }
+    return result;
+}
+
+template <typename T, typename Compare, typename Allocator>
 template<typename Predicate>
-typename binaryTree<T>::iterator binaryTree<T>::find_if(Predicate pred)
+typename binaryTree<T, Compare, Allocator>::iterator binaryTree<T, Compare, Allocator>::find_if(Predicate pred)
 {
-    treeNode<T>* found = findIfRecursive(root, pred);                         // Рекурсивный поиск
-    return iterator(found, root);                                             // Возврат итератора
+    treeNode<T>* found = findIfNode(pred);                                    // Итеративный поиск
+    return iterator(found, this);                                             // Возврат итератора
 }
 
-template <typename T>
+template <typename T, typename Compare, typename Allocator>
 template<typename Predicate>
-typename binaryTree<T>::iterator binaryTree<T>::find_if(Predicate pred) const
+typename binaryTree<T, Compare, Allocator>::const_iterator binaryTree<T, Compare, Allocator>::find_if(Predicate pred) const
 {
-    treeNode<T>* found = findIfRecursive(root, pred);                         // Рекурсивный поиск (константный)
-    return iterator(found, root);                                             // Возврат итератора
+    treeNode<T>* found = findIfNode(pred);                                    // Итеративный поиск (константный)
+    return const_iterator(found, this);                                       // Возврат итератора
 }
 
-template <typename T>
+template <typename T, typename Compare, typename Allocator>
 template<typename Predicate>
-treeNode<T>* binaryTree<T>::findIfRecursive(treeNode<T>* node, Predicate pred) const
+treeNode<T>* binaryTree<T, Compare, Allocator>::findIfNode(Predicate pred) const
 {
-    if (node == nullptr) return nullptr;                                      // Базовый случай рекурсии
+    for (treeNode<T>* node = leftmost; node != nullptr; node = nextNode(node))            // Симметричный обход без стека
+    {
+        if (pred(node->data)) return node;                                    // Если условие выполнено
+    }
+    return nullptr;                                                           // Ни один узел не подошел
+}
 
-    if (pred(node->data)) return node;                                        // Если условие выполнено
+template <typename T, typename Compare, typename Allocator>
+treeNode<T>* binaryTree<T, Compare, Allocator>::nextNode(treeNode<T>* node)
+{
+    if (node->right != nullptr)                                               // Если есть правый потомок
+        return findMinNode(node->right);                                      // Минимум правого поддерева
 
-    treeNode<T>* leftResult = findIfRecursive(node->left, pred);              // Поиск в левом поддереве
-    if (leftResult != nullptr) return leftResult;                             // Если найден в левом поддереве
+    treeNode<T>* parent = node->parent;
+    while (parent != nullptr && node == parent->right)                        // Подъем пока текущий - правый потомок
+    {
+        node = parent;
+        parent = parent->parent;
+    }
+    return parent;
+}
+
+template <typename T, typename Compare, typename Allocator>
+treeNode<T>* binaryTree<T, Compare, Allocator>::prevNode(treeNode<T>* node)
+{
+    if (node->left != nullptr)                                                // Если есть левый потомок
+        return findMaxNode(node->left);                                       // Максимум левого поддерева
 
-    return findIfRecursive(node->right, pred);                                // Поиск в правом поддереве
+    treeNode<T>* parent = node->parent;
+    while (parent != nullptr && node == parent->left)                         // Подъем пока текущий - левый потомок
+    {
+        node = parent;
+        parent = parent->parent;
+    }
+    return parent;
 }
 
-template <typename T>
-void binaryTree<T>::printTree() const
+template <typename T, typename Compare, typename Allocator>
+void binaryTree<T, Compare, Allocator>::printTree() const
 {
-    printRecursive(root);                                                     // Рекурсивный вывод
+    printNodes(root);                                                         // Итеративный вывод
     std::cout << std::endl;                                                   // Перевод строки
 }
 
-template <typename T>
-void binaryTree<T>::printRecursive(treeNode<T>* node, int depth) const
+template <typename T, typename Compare, typename Allocator>
+void binaryTree<T, Compare, Allocator>::printNodes(treeNode<T>* node) const
 {
-    if (node == nullptr) return;                                              // Базовый случай рекурсии
+    std::vector<std::pair<treeNode<T>*, int>> stack;                          // Явный стек: узел и его глубина
+    int depth = 0;
+
+    while (node != nullptr || !stack.empty())                                 // Обход: правое поддерево, узел, левое
+    {
+        while (node != nullptr)                                               // Спуск по правым потомкам
+        {
+            stack.emplace_back(node, depth++);
+            node = node->right;
+        }
 
-    printRecursive(node->right, depth + 1);                                   // Вывод правого поддерева
+        node = stack.back().first;
+        depth = stack.back().second;
+        stack.pop_back();
 
-    for (int i = 0; i < depth; ++i)                                           // Отступы для визуализации уровня
-        std::cout << "   ";
-    std::cout << node->data << std::endl;                                     // Вывод данных узла
+        for (int i = 0; i < depth; ++i)                                       // Отступы для визуализации уровня
+            std::cout << "   ";
+        std::cout << node->data << std::endl;                                 // Вывод данных узла
 
-    printRecursive(node->left, depth + 1);                                    // Вывод левого поддерева
+        node = node->left;                                                    // Переход к левому поддереву
+        ++depth;
+    }
 }
 #endif // BINARY_TREE_H
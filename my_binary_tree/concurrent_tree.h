@@ -0,0 +1,138 @@
+#ifndef CONCURRENT_TREE_H
+#define CONCURRENT_TREE_H
+
+#include "persistent_tree.h"
+#include <memory>
+#include <mutex>
+#include <optional>
+
+// Дерево для одновременной работы читателей и одного писателя.
+// Читатели берут опубликованную версию persistent_tree и ищут в ней без
+// блокировок: версия неизменяема, поэтому каждый поиск видит целостное
+// состояние на момент публикации. Сам захват версии не lock-free:
+// std::atomic_load/atomic_store для shared_ptr в libstdc++ и libc++ берут
+// короткую блокировку из внутреннего пула мьютексов на время копирования
+// указателя (std::atomic_is_lock_free возвращает false), но никогда не ждут
+// писателя, строящего версию. Писатели выполняются по очереди под
+// мьютексом: строят следующую версию (копирование пути, O(log n) узлов)
+// и атомарно публикуют ее. Узлы, выпавшие из дерева, освобождаются подсчетом
+// ссылок, когда последний читатель отпускает старую версию.
+template <typename T, typename Compare = std::less<T>>
+class concurrent_tree
+{
+public:
+    using version_type = persistent_tree<T, Compare>;                     // Неизменяемая версия дерева
+
+private:
+    std::shared_ptr<const version_type> current;                          // Опубликованная версия
+    std::mutex writerMutex;                                               // Очередь писателей
+
+    std::shared_ptr<const version_type> acquire() const                   // Захват версии (блокировка только на копию указателя)
+    {
+        return std::atomic_load(&current);
+    }
+
+    template<typename Update>                                             // Построение и публикация следующей версии
+    auto publish(Update update);
+
+public:
+    concurrent_tree() : current(std::make_shared<const version_type>()) {}
+    explicit concurrent_tree(const Compare& comp)
+        : current(std::make_shared<const version_type>(comp)) {}
+
+    concurrent_tree(const concurrent_tree&) = delete;                     // Мьютекс писателей не копируется
+    concurrent_tree& operator=(const concurrent_tree&) = delete;
+
+    // Операции писателя (выполняются по очереди)
+    bool insert(const T& value);                                          // Вставка (false - элемент уже есть)
+    template<typename InputIterator>
+    size_t insert(InputIterator first, InputIterator last);               // Пакетная вставка одной публикацией
+    bool erase(const T& value);                                           // Удаление (false - элемента нет)
+    template<typename Key, typename KeyCompare>
+    bool erase(const Key& key, KeyCompare keyComp);                       // Удаление по ключу
+    void clear();                                                         // Публикация пустой версии
+
+    // Операции читателя (не ждут писателя)
+    version_type snapshot() const { return *acquire(); }                  // Версия на момент вызова за O(1)
+    size_t size() const { return acquire()->size(); }
+    bool empty() const { return acquire()->empty(); }
+
+    std::optional<T> find(const T& value) const;                          // Копия найденного элемента
+    bool contains(const T& value) const { return acquire()->contains(value); }
+    template<typename Key, typename KeyCompare>
+    std::optional<T> find(const Key& key, KeyCompare keyComp) const;      // Гетерогенный поиск
+    template<typename Key, typename KeyCompare>
+    bool contains(const Key& key, KeyCompare keyComp) const { return acquire()->contains(key, keyComp); }
+};
+
+template <typename T, typename Compare>
+template<typename Update>
+auto concurrent_tree<T, Compare>::publish(Update update)
+{
+    std::lock_guard<std::mutex> lock(writerMutex);
+    auto next = std::make_shared<version_type>(*current);                 // Копия корня, узлы общие
+    auto result = update(*next);
+    if (result)                                                           // Публикуется только измененная версия
+        std::atomic_store(&current, std::shared_ptr<const version_type>(std::move(next)));
+    return result;
+}
+
+template <typename T, typename Compare>
+bool concurrent_tree<T, Compare>::insert(const T& value)
+{
+    return publish([&value](version_type& next) { return next.insert(value); });
+}
+
+template <typename T, typename Compare>
+template<typename InputIterator>
+size_t concurrent_tree<T, Compare>::insert(InputIterator first, InputIterator last)
+{
+    return publish([&first, &last](version_type& next) {
+        size_t inserted = 0;
+        for (; first != last; ++first)                                    // Читатели видят пакет целиком или не видят вовсе
+            inserted += next.insert(*first) ? 1 : 0;
+        return inserted;
+    });
+}
+
+template <typename T, typename Compare>
+bool concurrent_tree<T, Compare>::erase(const T& value)
+{
+    return publish([&value](version_type& next) { return next.erase(value); });
+}
+
+template <typename T, typename Compare>
+template<typename Key, typename KeyCompare>
+bool concurrent_tree<T, Compare>::erase(const Key& key, KeyCompare keyComp)
+{
+    return publish([&key, &keyComp](version_type& next) { return next.erase(key, keyComp); });
+}
+
+template <typename T, typename Compare>
+void concurrent_tree<T, Compare>::clear()
+{
+    publish([](version_type& next) {
+        bool changed = !next.empty();
+        next.clear();
+        return changed;
+    });
+}
+
+template <typename T, typename Compare>
+std::optional<T> concurrent_tree<T, Compare>::find(const T& value) const
+{
+    auto version = acquire();                                             // Версия живет до конца поиска
+    const T* found = version->find(value);
+    return found ? std::optional<T>(*found) : std::nullopt;
+}
+
+template <typename T, typename Compare>
+template<typename Key, typename KeyCompare>
+std::optional<T> concurrent_tree<T, Compare>::find(const Key& key, KeyCompare keyComp) const
+{
+    auto version = acquire();
+    const T* found = version->find(key, keyComp);
+    return found ? std::optional<T>(*found) : std::nullopt;
+}
+
+#endif // CONCURRENT_TREE_H
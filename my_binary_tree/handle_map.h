@@ -0,0 +1,182 @@
+#ifndef HANDLE_MAP_H
+#define HANDLE_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Хэш-таблица с открытой адресацией для плотных 32-битных ключей (хэндлов).
+// Ключи и значения лежат в двух параллельных массивах: поиск проверяет
+// подряд идущие ключи (линейное пробирование) и обращается к значению только
+// при совпадении. Удаление сдвигает следующие элементы цепочки назад, поэтому
+// надгробия не нужны и длина цепочек не растет со временем.
+template <typename T>
+class handle_map
+{
+public:
+    using handle_type = std::uint32_t;
+    static constexpr handle_type empty_handle = 0xFFFFFFFFu;              // Свободная ячейка (не выдается как хэндл)
+
+private:
+    std::vector<handle_type> keys;                                        // Ключи ячеек (empty_handle - свободно)
+    std::vector<T> values;                                                // Значения ячеек
+    std::size_t count = 0;                                                // Количество занятых ячеек
+    unsigned shift = 32;                                                  // 32 - log2(емкость)
+
+    static constexpr std::size_t minCapacity = 8;                         // Емкость первой выделенной таблицы
+
+    std::size_t home(handle_type key) const                               // Начальная ячейка цепочки ключа
+    {
+        return static_cast<std::size_t>((key * 2654435769u) >> shift);    // Фибоначчиево хэширование
+    }
+    std::size_t mask() const { return keys.size() - 1; }
+
+    std::size_t slotOf(handle_type key) const;                            // Ячейка ключа (keys.size() - не найден)
+    void grow();                                                          // Удвоение емкости с перехэшированием
+
+public:
+    handle_map() = default;
+
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    void clear();
+    void reserve(std::size_t elements);                                   // Емкость под elements без перехэширования
+
+    T* find(handle_type key);                                             // Указатель на значение (nullptr - не найден)
+    const T* find(handle_type key) const;
+    bool contains(handle_type key) const { return slotOf(key) != keys.size(); }
+
+    std::pair<T*, bool> insert(handle_type key, T value);                 // Вставка (false - ключ уже есть, значение не меняется)
+    T& operator[](handle_type key);                                       // Значение ключа (создается по умолчанию)
+    bool erase(handle_type key);                                          // Удаление (false - ключа нет)
+
+    template<typename Function>
+    void for_each(Function function) const;                               // Обход пар (хэндл, значение) в порядке ячеек
+};
+
+template <typename T>
+std::size_t handle_map<T>::slotOf(handle_type key) const
+{
+    if (count == 0 || key == empty_handle) return keys.size();            // Пустая таблица или заведомо чужой ключ
+
+    for (std::size_t slot = home(key);; slot = (slot + 1) & mask())       // Цепочка заканчивается свободной ячейкой
+    {
+        if (keys[slot] == key) return slot;
+        if (keys[slot] == empty_handle) return keys.size();
+    }
+}
+
+template <typename T>
+void handle_map<T>::grow()
+{
+    std::size_t capacity = keys.empty() ? minCapacity : keys.size() * 2;
+
+    std::vector<handle_type> oldKeys(capacity, empty_handle);
+    std::vector<T> oldValues(capacity);
+    oldKeys.swap(keys);
+    oldValues.swap(values);
+
+    shift = 32;
+    for (std::size_t c = capacity; c > 1; c >>= 1)                        // Емкость - степень двойки
+        --shift;
+
+    for (std::size_t i = 0; i < oldKeys.size(); ++i)                      // Перенос занятых ячеек
+    {
+        if (oldKeys[i] == empty_handle) continue;
+        std::size_t slot = home(oldKeys[i]);
+        while (keys[slot] != empty_handle)
+            slot = (slot + 1) & mask();
+        keys[slot] = oldKeys[i];
+        values[slot] = std::move(oldValues[i]);
+    }
+}
+
+template <typename T>
+void handle_map<T>::clear()
+{
+    keys.clear();
+    values.clear();
+    count = 0;
+    shift = 32;
+}
+
+template <typename T>
+void handle_map<T>::reserve(std::size_t elements)
+{
+    while (elements * 4 > keys.size() * 3)                                // Заполнение не выше 3/4
+        grow();
+}
+
+template <typename T>
+T* handle_map<T>::find(handle_type key)
+{
+    std::size_t slot = slotOf(key);
+    return slot != keys.size() ? &values[slot] : nullptr;
+}
+
+template <typename T>
+const T* handle_map<T>::find(handle_type key) const
+{
+    std::size_t slot = slotOf(key);
+    return slot != keys.size() ? &values[slot] : nullptr;
+}
+
+template <typename T>
+std::pair<T*, bool> handle_map<T>::insert(handle_type key, T value)
+{
+    if (T* existing = find(key))                                          // Ключ уже есть
+        return { existing, false };
+
+    reserve(count + 1);                                                   // Рост до вставки: ячейка не сдвинется
+
+    std::size_t slot = home(key);
+    while (keys[slot] != empty_handle)
+        slot = (slot + 1) & mask();
+
+    keys[slot] = key;
+    values[slot] = std::move(value);
+    ++count;
+    return { &values[slot], true };
+}
+
+template <typename T>
+T& handle_map<T>::operator[](handle_type key)
+{
+    return *insert(key, T()).first;
+}
+
+template <typename T>
+bool handle_map<T>::erase(handle_type key)
+{
+    std::size_t hole = slotOf(key);
+    if (hole == keys.size()) return false;
+
+    // Сдвиг назад: элемент переносится в дыру, если его начальная ячейка не лежит между дырой и ним
+    for (std::size_t slot = (hole + 1) & mask(); keys[slot] != empty_handle; slot = (slot + 1) & mask())
+    {
+        std::size_t start = home(keys[slot]);
+        if (((slot - start) & mask()) >= ((slot - hole) & mask()))
+        {
+            keys[hole] = keys[slot];
+            values[hole] = std::move(values[slot]);
+            hole = slot;
+        }
+    }
+
+    keys[hole] = empty_handle;
+    values[hole] = T();                                                   // Освобождение ресурсов значения
+    --count;
+    return true;
+}
+
+template <typename T>
+template<typename Function>
+void handle_map<T>::for_each(Function function) const
+{
+    for (std::size_t slot = 0; slot < keys.size(); ++slot)
+        if (keys[slot] != empty_handle)
+            function(keys[slot], values[slot]);
+}
+
+#endif // HANDLE_MAP_H
@@ -0,0 +1,119 @@
+#ifndef NODE_POOL_H
+#define NODE_POOL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+// Пул узлов дерева: узлы выделяются из крупных блоков (слэбов) подряд,
+// освобожденные ячейки переиспользуются через список свободных ячеек.
+// Копии пула разделяют одну арену и считаются равными: деревья, созданные
+// на копиях одного пула, переносят узлы друг в друга без выделений.
+// release() освобождает арену только у единственного владельца; пока
+// арену разделяет другая копия (другое дерево, дескриптор извлеченного
+// узла), он возвращает false и ничего не меняет - узлы возвращаются по одному.
+template <typename Node>
+class node_pool
+{
+private:
+    union slot                                                            // Ячейка пула: либо узел, либо звено списка свободных
+    {
+        slot* next;
+        alignas(Node) unsigned char storage[sizeof(Node)];
+    };
+
+    struct arena                                                          // Общее состояние пула
+    {
+        std::vector<std::unique_ptr<slot[]>> slabs;                       // Выделенные блоки
+        slot* freeList = nullptr;                                         // Освобожденные ячейки
+        std::size_t used = 0;                                             // Занято ячеек в последнем блоке
+        std::size_t slabSize = 0;                                         // Размер последнего блока
+    };
+
+    static constexpr std::size_t firstSlabSize = 32;                      // Размер первого блока
+    static constexpr std::size_t maxSlabSize = 4096;                      // Предельный размер блока
+
+    std::shared_ptr<arena> state;                                         // Общая арена копий пула
+
+public:
+    node_pool() : state(std::make_shared<arena>()) {}                     // Конструктор по умолчанию (пустая арена)
+    node_pool(const node_pool& other) = default;                          // Копия разделяет арену оригинала
+    node_pool(node_pool&& other) noexcept = default;                      // Перемещение забирает арену
+    node_pool& operator=(const node_pool& other) = default;
+    node_pool& operator=(node_pool&& other) noexcept = default;
+
+    Node* allocate();                                                     // Выделение памяти под один узел
+    void deallocate(Node* node) noexcept;                                 // Возврат памяти узла в пул (деструктор не вызывается)
+    bool release() noexcept;                                              // Освобождение всей арены (false - арена разделена)
+
+    bool operator==(const node_pool& other) const { return state == other.state; }
+    bool operator!=(const node_pool& other) const { return state != other.state; }
+};
+
+template <typename Node>
+Node* node_pool<Node>::allocate()
+{
+    if (!state)                                                           // Пул был перемещен - новая арена
+        state = std::make_shared<arena>();
+
+    if (state->freeList != nullptr)                                       // Есть освобожденная ячейка
+    {
+        slot* cell = state->freeList;
+        state->freeList = cell->next;                                     // Снятие с вершины списка
+        return reinterpret_cast<Node*>(cell->storage);
+    }
+
+    if (state->used == state->slabSize)                                   // Текущий блок исчерпан
+    {
+        std::size_t size = state->slabSize == 0 ? firstSlabSize           // Размер блока растет вдвое
+                                                : std::min(state->slabSize * 2, maxSlabSize);
+        state->slabs.emplace_back(new slot[size]);                        // Новый блок
+        state->slabSize = size;
+        state->used = 0;
+    }
+
+    slot* cell = &state->slabs.back()[state->used++];                     // Следующая ячейка подряд
+    return reinterpret_cast<Node*>(cell->storage);
+}
+
+template <typename Node>
+void node_pool<Node>::deallocate(Node* node) noexcept
+{
+    if (node == nullptr) return;
+
+    slot* cell = reinterpret_cast<slot*>(node);                           // Ячейка кладется в список свободных
+    cell->next = state->freeList;
+    state->freeList = cell;
+}
+
+template <typename Node>
+bool node_pool<Node>::release() noexcept
+{
+    if (!state)                                                           // Перемещенный пул ничего не хранит
+        return true;
+    if (state.use_count() != 1)                                           // Арену используют другие копии пула
+        return false;
+
+    state->slabs.clear();                                                 // Освобождение блоков без обхода узлов
+    state->freeList = nullptr;
+    state->used = 0;
+    state->slabSize = 0;
+    return true;
+}
+
+// Распределитель, выделяющий каждый узел через new/delete (без пула)
+template <typename Node>
+class heap_node_allocator
+{
+public:
+    Node* allocate() { return static_cast<Node*>(::operator new(sizeof(Node))); }
+    void deallocate(Node* node) noexcept { ::operator delete(node); }
+    bool release() noexcept { return false; }                             // Узлы освобождаются только поштучно
+
+    bool operator==(const heap_node_allocator&) const { return true; }
+    bool operator!=(const heap_node_allocator&) const { return false; }
+};
+
+#endif // NODE_POOL_H
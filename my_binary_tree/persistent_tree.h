@@ -0,0 +1,280 @@
+#ifndef PERSISTENT_TREE_H
+#define PERSISTENT_TREE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+// Персистентное дерево поиска (АВЛ) с копированием пути: узлы неизменяемы
+// и разделяются между версиями через shared_ptr. Вставка и удаление создают
+// только O(log n) новых узлов на пути от корня, а snapshot() - это копия
+// указателя на корень за O(1). Снимок не меняется при последующих правках
+// исходного дерева и остается валидным, пока жив хотя бы один его экземпляр.
+template <typename T, typename Compare = std::less<T>>
+class persistent_tree
+{
+private:
+    struct node;
+    using nodePtr = std::shared_ptr<const node>;
+
+    struct node                                                           // Неизменяемый узел версии
+    {
+        T data;                                                           // Данные узла
+        nodePtr left;                                                     // Левое поддерево
+        nodePtr right;                                                    // Правое поддерево
+        int height;                                                       // Высота поддерева
+        size_t count;                                                     // Количество узлов в поддереве
+
+        node(const T& value, nodePtr l, nodePtr r)
+            : data(value), left(std::move(l)), right(std::move(r)),
+              height(1 + std::max(heightOf(left), heightOf(right))),
+              count(1 + countOf(left) + countOf(right)) {}
+    };
+
+    nodePtr root;                                                         // Корень текущей версии
+    Compare comparator;                                                   // Компаратор для упорядочивания
+
+    static int heightOf(const nodePtr& n) { return n ? n->height : 0; }
+    static size_t countOf(const nodePtr& n) { return n ? n->count : 0; }
+
+    static nodePtr makeNode(const T& data, nodePtr left, nodePtr right);  // Новый узел с готовыми поддеревьями
+    static nodePtr balance(const T& data, nodePtr left, nodePtr right);   // Новый узел с восстановлением баланса
+    nodePtr insertNode(const nodePtr& n, const T& value, bool& inserted) const;
+    template<typename Key, typename KeyCompare>
+    nodePtr eraseNode(const nodePtr& n, const Key& key, KeyCompare keyComp, bool& erased) const;
+    static nodePtr eraseMin(const nodePtr& n, const T*& minValue);        // Удаление минимума поддерева
+
+    class persistent_iterator                                             // Итератор обхода версии по возрастанию
+    {
+    private:
+        std::vector<const node*> path;                                    // Узлы, ожидающие посещения (вершина - текущий)
+
+        void pushLeft(const node* n)                                      // Спуск по левой ветви
+        {
+            for (; n != nullptr; n = n->left.get())
+                path.push_back(n);
+        }
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        persistent_iterator() = default;                                  // Итератор конца
+        persistent_iterator(const node* start, int height)                // Итератор на минимум поддерева
+        {
+            path.reserve(static_cast<size_t>(height));
+            pushLeft(start);
+        }
+
+        const T& operator*() const                                        // Оператор разыменования
+        {
+            if (path.empty())                                             // Проверка конца
+                throw std::runtime_error("Dereferencing end iterator");
+            return path.back()->data;
+        }
+
+        const T* operator->() const { return &**this; }                   // Оператор доступа к членам
+
+        persistent_iterator& operator++()                                 // Префиксный инкремент
+        {
+            if (path.empty())
+                throw std::runtime_error("Cannot increment end iterator");
+            const node* current = path.back();
+            path.pop_back();
+            pushLeft(current->right.get());                               // Следующий - минимум правого поддерева
+            return *this;
+        }
+
+        persistent_iterator operator++(int)                               // Постфиксный инкремент
+        {
+            persistent_iterator temp = *this;
+            ++(*this);
+            return temp;
+        }
+
+        bool operator==(const persistent_iterator& other) const
+        {
+            return path.empty() ? other.path.empty()
+                                : !other.path.empty() && path.back() == other.path.back();
+        }
+        bool operator!=(const persistent_iterator& other) const { return !(*this == other); }
+    };
+
+public:
+    using iterator = persistent_iterator;                                 // Узлы версии не изменяются
+    using const_iterator = persistent_iterator;
+
+    persistent_tree() = default;                                          // Пустое дерево
+    explicit persistent_tree(const Compare& comp) : comparator(comp) {}   // Пустое дерево с компаратором
+
+    // Копирование разделяет все узлы и стоит O(1)
+    persistent_tree snapshot() const { return *this; }                    // Неизменяемая версия на текущий момент
+
+    bool insert(const T& value);                                          // Вставка (false - эквивалентный элемент уже есть)
+    bool erase(const T& value) { return erase(value, comparator); }       // Удаление (false - элемента нет)
+    template<typename Key, typename KeyCompare>
+    bool erase(const Key& key, KeyCompare keyComp);                       // Удаление по ключу
+
+    void clear() { root.reset(); }                                        // Очистка (узлы снимков не затрагиваются)
+    size_t size() const { return countOf(root); }                         // Количество элементов за O(1)
+    bool empty() const { return !root; }
+    Compare key_comp() const { return comparator; }
+
+    iterator begin() const { return iterator(root.get(), heightOf(root)); }
+    iterator end() const { return iterator(); }
+
+    const T* find(const T& value) const { return find(value, comparator); }
+    bool contains(const T& value) const { return find(value) != nullptr; }
+    template<typename Key, typename KeyCompare>
+    const T* find(const Key& key, KeyCompare keyComp) const;              // Указатель на элемент (nullptr - не найден)
+    template<typename Key, typename KeyCompare>
+    bool contains(const Key& key, KeyCompare keyComp) const { return find(key, keyComp) != nullptr; }
+};
+
+template <typename T, typename Compare>
+typename persistent_tree<T, Compare>::nodePtr
+persistent_tree<T, Compare>::makeNode(const T& data, nodePtr left, nodePtr right)
+{
+    return std::make_shared<const node>(data, std::move(left), std::move(right));
+}
+
+template <typename T, typename Compare>
+typename persistent_tree<T, Compare>::nodePtr
+persistent_tree<T, Compare>::balance(const T& data, nodePtr left, nodePtr right)
+{
+    int leftHeight = heightOf(left);
+    int rightHeight = heightOf(right);
+
+    if (leftHeight > rightHeight + 1)                                     // Перевес слева
+    {
+        const node* l = left.get();
+        if (heightOf(l->left) >= heightOf(l->right))                      // Малый правый поворот
+            return makeNode(l->data, l->left, makeNode(data, l->right, std::move(right)));
+
+        const node* lr = l->right.get();                                  // Большой правый поворот
+        return makeNode(lr->data, makeNode(l->data, l->left, lr->left),
+                        makeNode(data, lr->right, std::move(right)));
+    }
+
+    if (rightHeight > leftHeight + 1)                                     // Перевес справа
+    {
+        const node* r = right.get();
+        if (heightOf(r->right) >= heightOf(r->left))                      // Малый левый поворот
+            return makeNode(r->data, makeNode(data, std::move(left), r->left), r->right);
+
+        const node* rl = r->left.get();                                   // Большой левый поворот
+        return makeNode(rl->data, makeNode(data, std::move(left), rl->left),
+                        makeNode(r->data, rl->right, r->right));
+    }
+
+    return makeNode(data, std::move(left), std::move(right));
+}
+
+template <typename T, typename Compare>
+bool persistent_tree<T, Compare>::insert(const T& value)
+{
+    bool inserted = false;
+    nodePtr updated = insertNode(root, value, inserted);                  // Новая версия строится рядом со старой
+    root = std::move(updated);                                            // Публикация новой версии
+    return inserted;
+}
+
+template <typename T, typename Compare>
+typename persistent_tree<T, Compare>::nodePtr
+persistent_tree<T, Compare>::insertNode(const nodePtr& n, const T& value, bool& inserted) const
+{
+    if (!n)                                                               // Место вставки найдено
+    {
+        inserted = true;
+        return makeNode(value, nullptr, nullptr);
+    }
+
+    if (comparator(value, n->data))                                       // Вставка в левое поддерево
+    {
+        nodePtr left = insertNode(n->left, value, inserted);
+        return inserted ? balance(n->data, std::move(left), n->right) : n;
+    }
+    if (comparator(n->data, value))                                       // Вставка в правое поддерево
+    {
+        nodePtr right = insertNode(n->right, value, inserted);
+        return inserted ? balance(n->data, n->left, std::move(right)) : n;
+    }
+    return n;                                                             // Эквивалентный элемент - версия не меняется
+}
+
+template <typename T, typename Compare>
+template<typename Key, typename KeyCompare>
+bool persistent_tree<T, Compare>::erase(const Key& key, KeyCompare keyComp)
+{
+    bool erased = false;
+    nodePtr updated = eraseNode(root, key, keyComp, erased);
+    root = std::move(updated);
+    return erased;
+}
+
+template <typename T, typename Compare>
+template<typename Key, typename KeyCompare>
+typename persistent_tree<T, Compare>::nodePtr
+persistent_tree<T, Compare>::eraseNode(const nodePtr& n, const Key& key, KeyCompare keyComp, bool& erased) const
+{
+    if (!n)                                                               // Элемент не найден
+        return n;
+
+    if (keyComp(key, n->data))                                            // Удаление из левого поддерева
+    {
+        nodePtr left = eraseNode(n->left, key, keyComp, erased);
+        return erased ? balance(n->data, std::move(left), n->right) : n;
+    }
+    if (keyComp(n->data, key))                                            // Удаление из правого поддерева
+    {
+        nodePtr right = eraseNode(n->right, key, keyComp, erased);
+        return erased ? balance(n->data, n->left, std::move(right)) : n;
+    }
+
+    erased = true;
+    if (!n->left) return n->right;                                        // Не более одного потомка
+    if (!n->right) return n->left;
+
+    const T* successor = nullptr;                                         // Узел заменяется минимумом правого поддерева
+    nodePtr right = eraseMin(n->right, successor);
+    return balance(*successor, n->left, std::move(right));                // Старый узел жив, пока жив n
+}
+
+template <typename T, typename Compare>
+typename persistent_tree<T, Compare>::nodePtr
+persistent_tree<T, Compare>::eraseMin(const nodePtr& n, const T*& minValue)
+{
+    if (!n->left)                                                         // Минимум найден
+    {
+        minValue = &n->data;
+        return n->right;
+    }
+    nodePtr left = eraseMin(n->left, minValue);
+    return balance(n->data, std::move(left), n->right);
+}
+
+template <typename T, typename Compare>
+template<typename Key, typename KeyCompare>
+const T* persistent_tree<T, Compare>::find(const Key& key, KeyCompare keyComp) const
+{
+    const node* current = root.get();
+    while (current != nullptr)                                            // Обычный спуск по ключу
+    {
+        if (keyComp(key, current->data))
+            current = current->left.get();
+        else if (keyComp(current->data, key))
+            current = current->right.get();
+        else
+            return &current->data;
+    }
+    return nullptr;
+}
+
+#endif // PERSISTENT_TREE_H
@@ -5,6 +5,7 @@
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <iterator>
 
 template <typename T>
 class tree_algorithms
@@ -47,6 +48,7 @@ std::vector<typename tree_algorithms<T>::value_type>
 tree_algorithms<T>::get_sorted_ascending(ForwardIterator begin, ForwardIterator end)
 {
     std::vector<value_type> result;                                       // Вектор для хранения результата
+    result.reserve(static_cast<size_t>(std::distance(begin, end)));       // Лишний проход дешевле перевыделений с копированием
     for (auto it = begin; it != end; ++it)                                // Проход от начала до конца
         result.push_back(*it);                                            // Добавление элемента в вектор
     return result;                                                        // Возврат отсортированного вектора
@@ -58,6 +60,7 @@ std::vector<typename tree_algorithms<T>::value_type>
 tree_algorithms<T>::get_sorted_descending(ReverseIterator rbegin, ReverseIterator rend)
 {
     std::vector<value_type> result;                                       // Вектор для хранения результата
+    result.reserve(static_cast<size_t>(std::distance(rbegin, rend)));     // Лишний проход дешевле перевыделений с копированием
     for (auto rit = rbegin; rit != rend; ++rit)                           // Обратный проход от rbegin до rend
         result.push_back(*rit);                                            // Добавление элемента в вектор
     return result;                                                        // Возврат отсортированного в обратном порядке вектора
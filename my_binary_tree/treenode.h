@@ -1,10 +1,14 @@
 #ifndef TREE_NODE_H
 #define TREE_NODE_H
 
+#include <cstddef>
+
+enum class nodeColor { RED, BLACK };                                          // Цвет узла красно-черного дерева
+
 template <typename T>
 class treeNode
 {
-    template <typename U>
+    template <typename U, typename Compare, typename Allocator>
     friend class binaryTree;
     template <typename U>
     friend class tree_iterator;
@@ -16,10 +20,12 @@ private:
     treeNode* left;
     treeNode* right;
     treeNode* parent;  // Добавляем указатель на родителя
+    nodeColor color;   // Цвет узла (новые узлы красные)
+    size_t count;      // Количество узлов в поддереве (включая этот)
 
 public:
     treeNode(const T& value)
-        : data(value), left(nullptr), right(nullptr), parent(nullptr) {}
+        : data(value), left(nullptr), right(nullptr), parent(nullptr), color(nodeColor::RED), count(1) {}
 
     T getData() const { return data; }
 };
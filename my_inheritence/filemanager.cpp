@@ -354,7 +354,15 @@ bool FileManager::loadStockData(std::vector<std::shared_ptr<Pharmacy>>& pharmaci
                 auto medicineIt = medicineMap.find(record.productId);        // Поиск лекарства
 
                 if (pharmacyIt != pharmacyMap.end() && medicineIt != medicineMap.end())
-                    pharmacyIt->second->addToStorage(medicineIt->second, record.quantity); // Добавление в склад
+                {
+                    StockLot lot;                                                // Запись файла - одна партия
+                    lot.lotId = record.lotId;
+                    lot.receiptDate = record.receiptDate;
+                    lot.expirationDate = record.expirationDate ? *record.expirationDate
+                                                               : medicineIt->second->getExpirationSafeDate();
+                    lot.quantity = record.quantity;
+                    pharmacyIt->second->receiveLot(medicineIt->second, lot);     // Добавление партии в склад
+                }
             }
         }
         return true;
@@ -379,15 +387,12 @@ bool FileManager::saveStockData(const std::vector<std::shared_ptr<Pharmacy>>& ph
             for (const auto& productPair : products)
             {
                 const auto& product = productPair.first;
-                int quantity = productPair.second;
+                if (!product || productPair.second <= 0) continue;
 
-                if (product && quantity > 0)
+                for (const auto& lot : pharmacy->getLots(product->getId()))  // Каждая партия - отдельная запись
                 {
-                    std::time_t t = std::time(nullptr);
-                    std::tm* now = std::localtime(&t);
-                    SafeDate currentDate(*now);                               // Текущая дата
-
-                    StockRecord record(product->getId(), pharmacy->getId(), quantity, currentDate);
+                    StockRecord record(product->getId(), pharmacy->getId(), lot.quantity,
+                                       lot.receiptDate, lot.lotId, lot.expirationDate);
                     stockFile.Write_record_in_file_text(record);             // Запись записи о запасе
                 }
             }
@@ -0,0 +1,50 @@
+#include "idinterner.h"
+#include <mutex>
+#include <stdexcept>
+
+IdInterner& IdInterner::getInstance()
+{
+    static IdInterner instance;                                                     // Создается при первом обращении
+    return instance;
+}
+
+IdInterner::Handle IdInterner::intern(const std::string& id)
+{
+    Handle existing = find(id);                                                     // Обычный случай - строка уже есть
+    if (existing != invalidHandle)
+        return existing;
+
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    auto it = handles.find(id);                                                     // Строку мог добавить другой поток
+    if (it != handles.end())
+        return it->second;
+
+    if (names.size() >= invalidHandle)                                              // Последнее значение зарезервировано
+        throw std::length_error("ID interner is full");
+
+    Handle handle = static_cast<Handle>(names.size());
+    names.push_back(id);
+    handles.emplace(std::string_view(names.back()), handle);                        // Ключ ссылается на хранимую копию
+    return handle;
+}
+
+IdInterner::Handle IdInterner::find(const std::string& id) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    auto it = handles.find(std::string_view(id));
+    return it != handles.end() ? it->second : invalidHandle;
+}
+
+const std::string& IdInterner::name(Handle handle) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    if (handle >= names.size())                                                     // Хэндл не выдавался
+        throw std::out_of_range("Unknown ID handle");
+    return names[handle];                                                           // Ссылка действительна до конца программы
+}
+
+size_t IdInterner::size() const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return names.size();
+}
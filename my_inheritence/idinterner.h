@@ -0,0 +1,41 @@
+#ifndef IDINTERNER_H
+#define IDINTERNER_H
+
+#include <cstdint>
+#include <deque>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Глобальная таблица строковых ID: каждой строке один раз выдается плотный
+// 32-битный хэндл, а сама строка хранится в единственном экземпляре.
+// Каталог и склады хранят хэндлы вместо копий строк (ID продуктов и номера
+// партий) и ищут по ним в handle_map. Хэндлы не освобождаются - набор ID
+// в программе ограничен.
+class IdInterner
+{
+public:
+    using Handle = std::uint32_t;
+    static constexpr Handle invalidHandle = 0xFFFFFFFFu;                            // Строка не встречалась
+
+private:
+    std::deque<std::string> names;                                                  // Строки по хэндлам (адреса не меняются)
+    std::unordered_map<std::string_view, Handle> handles;                           // Строка -> хэндл (ключи указывают в names)
+    mutable std::shared_mutex mutex;                                                // Поиски параллельно, выдача по одному
+
+    IdInterner() = default;
+
+public:
+    IdInterner(const IdInterner&) = delete;
+    IdInterner& operator=(const IdInterner&) = delete;
+
+    static IdInterner& getInstance();
+
+    Handle intern(const std::string& id);                                           // Хэндл строки (выдается при первом обращении)
+    Handle find(const std::string& id) const;                                       // Хэндл без выдачи (invalidHandle - нет)
+    const std::string& name(Handle handle) const;                                   // Строка по хэндлу
+    size_t size() const;
+};
+
+#endif // IDINTERNER_H
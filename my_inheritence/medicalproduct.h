@@ -36,6 +36,7 @@ public:
     std::string getName() const { return name; }
     double getBasePrice() const { return basePrice; }
     std::string getExpirationDate() const { return expirationDate.toString(); }
+    const SafeDate& getExpirationSafeDate() const { return expirationDate; }
     std::string getManufacturerCountry() const { return manufacturerCountry; }
 
     void setExpDate (SafeDate newExpDate){this->expirationDate = newExpDate;}
@@ -78,6 +78,13 @@ void Medicine::removeAnalogue(const std::string& analogueId)
     if (analogueId.empty())                                  // Проверка пустого ID
         throw std::invalid_argument("Analogue ID cannot be empty");
 
+    if (!removeAnalogueIfPresent(analogueId))                // Если аналог не найден
+        throw std::runtime_error("Analogue not found: " + analogueId);
+}
+
+// Удаление аналога по ID, если он есть
+bool Medicine::removeAnalogueIfPresent(const std::string& analogueId)
+{
     // Перемещение удаляемых элементов в конец вектора
     auto it = std::remove_if(analogues.begin(), analogues.end(),
                              [&analogueId](const std::shared_ptr<Medicine>& analogue)
@@ -85,10 +92,11 @@ void Medicine::removeAnalogue(const std::string& analogueId)
                                  return analogue->getId() == analogueId;
                              });
 
-    if (it != analogues.end())                               // Если элементы для удаления найдены
-        analogues.erase(it, analogues.end());                // Удаление элементов из вектора
-    else
-        throw std::runtime_error("Analogue not found: " + analogueId);
+    if (it == analogues.end())                               // Удалять нечего
+        return false;
+
+    analogues.erase(it, analogues.end());                    // Удаление элементов из вектора
+    return true;
 }
 
 // Получение всех аналогов
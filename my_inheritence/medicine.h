@@ -31,6 +31,7 @@ public:
     // Методы для работы с аналогами
     void addAnalogue(std::shared_ptr<Medicine> analogue);
     void removeAnalogue(const std::string& analogueId);
+    bool removeAnalogueIfPresent(const std::string& analogueId);
     const std::vector<std::shared_ptr<Medicine>>& getAnalogues() const;
     void addAnalogueById(const std::string& analogueId,
                          const std::vector<std::shared_ptr<Medicine>>& allMedicines);
@@ -43,7 +44,7 @@ public:
 
     // Геттеры
     bool getIsPrescription() const { return isPrescription; }
-    std::string getActiveSubstance() const { return activeSubstance; }
+    const std::string& getActiveSubstance() const { return activeSubstance; }
     std::string getInstructions() const { return instructions; }
 
     // Операторы
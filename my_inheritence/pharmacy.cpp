@@ -6,6 +6,7 @@
 #include "Exception/PharmacyExceptions/InvalidProductDataException.h"
 #include "Exception/PharmacyExceptions/ProductNotFoundException.h"
 #include "Exception/PharmacyExceptions/DuplicateProductException.h"
+#include "Exception/InventoryExceptions/StorageOperationException.h"
 
 Pharmacy::Pharmacy(const std::string& id, const std::string& name, const std::string& addr, const std::string& phone,
                    double rent)
@@ -20,8 +21,11 @@ Pharmacy::Pharmacy()
 
 Pharmacy::Pharmacy(const Pharmacy& other)
     : id(other.id), name(other.name), address(other.address),
-    phoneNumber(other.phoneNumber), rentCost(other.rentCost), storage(other.storage)
+    phoneNumber(other.phoneNumber), rentCost(other.rentCost)
 {
+    std::unique_lock<std::shared_mutex> lock(other.storageMutex);                   // Склад копируется целостным
+    storage = other.storage;
+    storage.clearReservations();                                                    // Брони принадлежат оригиналу
 }
 
 void Pharmacy::addToStorage(std::shared_ptr<MedicalProduct> product, int quantity)
@@ -32,10 +36,25 @@ void Pharmacy::addToStorage(std::shared_ptr<MedicalProduct> product, int quantit
     if (quantity <= 0)                                                              // Проверка положительности количества
         throw InvalidProductDataException("quantity", "must be positive");
 
+    std::unique_lock<std::shared_mutex> lock(storageMutex);                         // Новая строка склада
     if (storage.contains(product->getId()))                                         // Проверка дубликата продукта
         throw DuplicateProductException(product->getId());
 
     storage.addProduct(product, quantity);                                          // Добавление продукта на склад
+    notifyStock(product, quantity);                                                 // Продукт появился на складе
+}
+
+void Pharmacy::receiveLot(std::shared_ptr<MedicalProduct> product, const StockLot& lot)
+{
+    if (!product)                                                                   // Проверка нулевого указателя
+        throw InvalidProductDataException("product", "cannot be null");
+
+    if (lot.quantity <= 0)                                                          // Проверка положительности количества
+        throw InvalidProductDataException("quantity", "must be positive");
+
+    std::unique_lock<std::shared_mutex> lock(storageMutex);
+    storage.addLot(product, lot);                                                   // Партия добавляется к имеющимся
+    notifyStock(product, storage.getQuantity(product->getId()));                    // Новый общий остаток
 }
 
 void Pharmacy::removeFromStorage(const std::string& productId, int quantity)
@@ -46,19 +65,134 @@ void Pharmacy::removeFromStorage(const std::string& productId, int quantity)
     if (quantity <= 0)                                                              // Проверка положительности количества
         throw InvalidProductDataException("quantity", "must be positive");
 
-    if (!storage.contains(productId))                                               // Проверка существования продукта
-        throw ProductNotFoundException(productId);
+    int remaining;
+    {
+        std::shared_lock<std::shared_mutex> shared(storageMutex);                   // Состав склада не меняется
+        std::lock_guard<std::mutex> lock(stripeFor(productId).mutex);               // Проверка и списание - одно действие
 
-    storage.removeProduct(productId, quantity);                                     // Удаление продукта со склада
+        auto product = storage.getProduct(productId);                               // Запись может быть удалена со склада
+        if (!product)                                                               // Проверка существования продукта
+            throw ProductNotFoundException(productId);
+
+        remaining = storage.takeProduct(productId, quantity);                       // Списание с ранних партий (FEFO)
+        notifyStock(product, remaining);                                            // Остаток после списания
+    }
+
+    if (remaining == 0)                                                             // Пустая строка удаляется отдельно
+        eraseIfEmpty(productId);
 }
 
 int Pharmacy::checkStock(const std::string& productId) const
 {
     if (productId.empty())                                                          // Проверка пустого ID
         throw std::invalid_argument("Product ID cannot be empty");
+
+    std::shared_lock<std::shared_mutex> shared(storageMutex);
+    std::lock_guard<std::mutex> lock(stripeFor(productId).mutex);
     return storage.getQuantity(productId);                                          // Возврат количества на складе
 }
 
+void Pharmacy::setStockListener(StockListener listener)
+{
+    std::unique_lock<std::shared_mutex> lock(storageMutex);                         // Продажи ждут, пока слушатели не сверены со складом
+    storage.for_each([this](const std::shared_ptr<MedicalProduct>& product, int) {
+        notifyStock(product, 0);                                                    // Прежний слушатель забывает склад
+    });
+
+    stockListener = std::move(listener);                                            // Замена предыдущего слушателя
+    storage.for_each([this](const std::shared_ptr<MedicalProduct>& product, int quantity) {
+        notifyStock(product, quantity);                                             // Новый слушатель получает текущие остатки
+    });
+}
+
+Pharmacy::StockReservation Pharmacy::reserve(const std::string& productId, int quantity)
+{
+    if (productId.empty())                                                          // Проверка пустого ID
+        throw InvalidProductDataException("product ID", "cannot be empty");
+
+    if (quantity <= 0)                                                              // Проверка положительности количества
+        throw InvalidProductDataException("quantity", "must be positive");
+
+    std::shared_lock<std::shared_mutex> shared(storageMutex);
+    ReservationStripe& stripe = stripeFor(productId);
+    std::lock_guard<std::mutex> lock(stripe.mutex);
+
+    if (!storage.contains(productId))                                               // Проверка существования продукта
+        throw ProductNotFoundException(productId);
+
+    storage.reserve(productId, quantity);                                           // Исключение, если свободных единиц мало
+
+    StockReservation reservation;
+    reservation.id = nextReservationId.fetch_add(1, std::memory_order_relaxed);
+    reservation.productId = productId;
+    reservation.quantity = quantity;
+    stripe.pending.emplace(reservation.id, std::make_pair(productId, quantity));
+    return reservation;
+}
+
+void Pharmacy::commit(const StockReservation& reservation)
+{
+    int remaining;
+    {
+        std::shared_lock<std::shared_mutex> shared(storageMutex);
+        ReservationStripe& stripe = stripeFor(reservation.productId);
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+
+        auto pending = stripe.pending.find(reservation.id);                         // Бронь закрывается только один раз
+        if (pending == stripe.pending.end() || pending->second.first != reservation.productId)
+            throw StorageOperationException("commit", id, "unknown reservation " + std::to_string(reservation.id));
+
+        auto product = storage.getProduct(reservation.productId);
+        remaining = storage.commitReservation(reservation.productId, pending->second.second);
+        stripe.pending.erase(pending);
+        notifyStock(product, remaining);                                            // Остаток после продажи
+    }
+
+    if (remaining == 0)
+        eraseIfEmpty(reservation.productId);
+}
+
+void Pharmacy::cancel(const StockReservation& reservation)
+{
+    std::shared_lock<std::shared_mutex> shared(storageMutex);
+    ReservationStripe& stripe = stripeFor(reservation.productId);
+    std::lock_guard<std::mutex> lock(stripe.mutex);
+
+    auto pending = stripe.pending.find(reservation.id);
+    if (pending == stripe.pending.end() || pending->second.first != reservation.productId)
+        throw StorageOperationException("cancel", id, "unknown reservation " + std::to_string(reservation.id));
+
+    storage.releaseReservation(reservation.productId, pending->second.second);      // Остаток не меняется
+    stripe.pending.erase(pending);
+}
+
+int Pharmacy::getAvailableStock(const std::string& productId) const
+{
+    if (productId.empty())                                                          // Проверка пустого ID
+        throw InvalidProductDataException("product ID", "cannot be empty");
+
+    std::shared_lock<std::shared_mutex> shared(storageMutex);
+    std::lock_guard<std::mutex> lock(stripeFor(productId).mutex);
+    return storage.getAvailable(productId);
+}
+
+Pharmacy::ReservationStripe& Pharmacy::stripeFor(const std::string& productId) const
+{
+    return stripes[std::hash<std::string>()(productId) % stripeCount];              // Продукт всегда попадает в одну полосу
+}
+
+void Pharmacy::eraseIfEmpty(const std::string& productId)
+{
+    std::unique_lock<std::shared_mutex> lock(storageMutex);
+    storage.eraseIfEmpty(productId);                                                // Строку могли пополнить до блокировки
+}
+
+void Pharmacy::notifyStock(const std::shared_ptr<MedicalProduct>& product, int quantity) const
+{
+    if (stockListener)                                                              // Слушатель может быть не задан
+        stockListener(*this, product, quantity);
+}
+
 std::vector<std::shared_ptr<Medicine>> Pharmacy::findAvailableAnalogues(const std::string& medicineId) const
 {
     if (medicineId.empty())                                                         // Проверка пустого ID лекарства
@@ -66,11 +200,12 @@ std::vector<std::shared_ptr<Medicine>> Pharmacy::findAvailableAnalogues(const st
 
     std::vector<std::shared_ptr<Medicine>> result;                                  // Вектор для результатов
 
-    auto productIt = storage.items.find(medicineId);                                // Поиск лекарства в хранилище
-    if (productIt == storage.items.end())                                           // Если лекарство не найдено
+    std::unique_lock<std::shared_mutex> lock(storageMutex);                         // Несколько строк читаются согласованно
+    auto product = storage.getProduct(medicineId);                                  // Поиск лекарства в хранилище
+    if (!product)                                                                   // Если лекарство не найдено
         return result;
 
-    auto medicine = std::dynamic_pointer_cast<Medicine>(productIt->second.first);   // Приведение к типу Medicine
+    auto medicine = std::dynamic_pointer_cast<Medicine>(product);                   // Приведение к типу Medicine
     if (!medicine)                                                                  // Если продукт не является лекарством
         return result;
 
@@ -78,7 +213,7 @@ std::vector<std::shared_ptr<Medicine>> Pharmacy::findAvailableAnalogues(const st
 
     for (const auto& analogue : analogues)                                          // Проход по всем аналогам
     {
-        if (storage.contains(analogue->getId()) && storage.getQuantity(analogue->getId()) > 0)  // Проверка наличия
+        if (storage.getQuantity(analogue->getId()) > 0)                             // Проверка наличия
             result.push_back(analogue);                                             // Добавление доступного аналога
     }
 
@@ -87,36 +222,97 @@ std::vector<std::shared_ptr<Medicine>> Pharmacy::findAvailableAnalogues(const st
 
 std::vector<std::pair<std::shared_ptr<MedicalProduct>, int>> Pharmacy::getAllProducts() const
 {
-    std::vector<std::pair<std::shared_ptr<MedicalProduct>, int>> result;            // Вектор для всех продуктов
+    std::unique_lock<std::shared_mutex> lock(storageMutex);                         // Согласованный снимок всех строк
+    return storage.getAllItems();                                                   // Пары продукт-количество в порядке ID
+}
 
-    for (const auto& item : storage.items)                                          // Проход по всем элементам хранилища
-        result.emplace_back(item.second.first, item.second.second);                 // Добавление пары продукт-количество
+std::vector<StockLot> Pharmacy::getLots(const std::string& productId) const
+{
+    if (productId.empty())                                                          // Проверка пустого ID
+        throw InvalidProductDataException("product ID", "cannot be empty");
 
-    return result;                                                                  // Возврат списка всех продуктов
+    std::shared_lock<std::shared_mutex> shared(storageMutex);
+    std::lock_guard<std::mutex> lock(stripeFor(productId).mutex);
+    return storage.getLots(productId);                                              // Партии по сроку годности
+}
+
+std::vector<std::pair<std::shared_ptr<MedicalProduct>, StockLot>> Pharmacy::removeExpiredLots(const SafeDate& date)
+{
+    std::unique_lock<std::shared_mutex> lock(storageMutex);                         // Строки могут удаляться
+    auto removed = storage.removeExpired(date.toDayNumber());                       // Снятие только истекших партий
+
+    std::vector<std::shared_ptr<MedicalProduct>> changed;                           // Продукты, чей остаток изменился
+    for (const auto& entry : removed)
+        if (changed.empty() || changed.back() != entry.first)                      // Партии продукта идут подряд
+            changed.push_back(entry.first);
+    for (const auto& product : changed)
+        notifyStock(product, storage.getQuantity(product->getId()));
+
+    return removed;                                                                 // Снятые партии для акта списания
+}
+
+long long Pharmacy::getTotalUnits() const
+{
+    std::unique_lock<std::shared_mutex> lock(storageMutex);
+    return storage.totalUnits();                                                    // Проход по столбцу количеств
+}
+
+double Pharmacy::getStockValue() const
+{
+    std::unique_lock<std::shared_mutex> lock(storageMutex);
+    return storage.valueOnHand();
+}
+
+std::vector<std::string> Pharmacy::getLowStockProducts(int reorderLevel) const
+{
+    if (reorderLevel <= 0)                                                          // Порог должен быть положительным
+        throw std::invalid_argument("Reorder level must be positive");
+
+    std::unique_lock<std::shared_mutex> lock(storageMutex);
+    return storage.getItemsBelow(reorderLevel);
+}
+
+long long Pharmacy::getUnitsExpiringBefore(const SafeDate& date) const
+{
+    std::unique_lock<std::shared_mutex> lock(storageMutex);
+    return storage.unitsExpiringBefore(date.toDayNumber());                         // Сравнение дат как чисел
 }
 
 Pharmacy& Pharmacy::operator=(const Pharmacy& other)
 {
     if (this != &other)                                                             // Проверка самоприсваивания
     {
+        std::scoped_lock lock(storageMutex, other.storageMutex);                    // Оба склада без параллельных продаж
+
+        storage.for_each([this](const std::shared_ptr<MedicalProduct>& product, int) {
+            notifyStock(product, 0);                                                // Старые продукты уходят со склада
+        });
+
         id = other.id;                                                              // Копирование ID
         name = other.name;                                                          // Копирование названия
         address = other.address;                                                    // Копирование адреса
         phoneNumber = other.phoneNumber;                                            // Копирование телефона
         rentCost = other.rentCost;                                                  // Копирование стоимости аренды
         storage = other.storage;                                                    // Копирование склада
+        storage.clearReservations();                                                // Брони принадлежат оригиналу
+        for (auto& stripe : stripes)                                                // Старые брони этой аптеки больше не действуют
+            stripe.pending.clear();
+        storage.for_each([this](const std::shared_ptr<MedicalProduct>& product, int quantity) {
+            notifyStock(product, quantity);                                         // Слушатель видит новый склад
+        });
     }
     return *this;                                                                   // Возврат текущего объекта
 }
 
 std::ostream& operator<<(std::ostream& os, const Pharmacy& pharmacy)
 {
+    std::shared_lock<std::shared_mutex> lock(pharmacy.storageMutex);               // Число строк меняется только монопольно
     os << pharmacy.id << ";"                                                        // Вывод ID аптеки
        << pharmacy.name << ";"                                                      // Вывод названия аптеки
        << pharmacy.address << ";"                                                   // Вывод адреса
        << pharmacy.phoneNumber << ";"                                               // Вывод телефона
        << pharmacy.rentCost << ";"                                                  // Вывод стоимости аренды
-       << pharmacy.storage.items.size();                                            // Вывод количества продуктов
+       << pharmacy.storage.size();                                               // Вывод количества продуктов
 
     return os;                                                                      // Возврат потока
 }
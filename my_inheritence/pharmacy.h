@@ -3,13 +3,44 @@
 
 #include "medicine.h"
 #include "medicalproduct.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <vector>
 #include <memory>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
 #include "storage.h"
 
 class Pharmacy
 {
+public:
+    // Слушатель изменений склада: аптека, продукт и новое количество (0 - продукт убран)
+    using StockListener = std::function<void(const Pharmacy&, const std::shared_ptr<MedicalProduct>&, int)>;
+
+    // Бронь кассы: единицы недоступны другим продажам до commit или cancel
+    struct StockReservation
+    {
+        std::uint64_t id = 0;                                                       // 0 - пустая бронь
+        std::string productId;
+        int quantity = 0;
+    };
+
 private:
+    // Блокировки склада: операции с одной строкой (продажа, бронь, проверка
+    // остатка) идут под общей блокировкой склада и блокировкой полосы своего
+    // продукта, поэтому кассы с разными продуктами не мешают друг другу.
+    // Изменение состава склада и обзорные запросы берут склад монопольно.
+    struct ReservationStripe
+    {
+        std::mutex mutex;                                                           // Блокировка строк полосы
+        std::unordered_map<std::uint64_t, std::pair<std::string, int>> pending;     // Открытые брони: ID -> продукт, количество
+    };
+
+    static constexpr size_t stripeCount = 16;
+
     std::string id;
     std::string name;
     std::string address;
@@ -17,6 +48,15 @@ private:
     double rentCost;
 
     Storage storage;
+    StockListener stockListener;                                                    // Не копируется вместе с аптекой
+
+    mutable std::shared_mutex storageMutex;                                         // Общая - строки, монопольная - состав склада
+    mutable std::array<ReservationStripe, stripeCount> stripes;                     // Брони не копируются вместе с аптекой
+    std::atomic<std::uint64_t> nextReservationId{1};
+
+    void notifyStock(const std::shared_ptr<MedicalProduct>& product, int quantity) const;
+    ReservationStripe& stripeFor(const std::string& productId) const;
+    void eraseIfEmpty(const std::string& productId);                                // Удаление опустевшей строки
 
 public:
     Pharmacy(const std::string& id, const std::string& name, const std::string& addr, const std::string& phone,
@@ -27,8 +67,18 @@ public:
 
     // Управление складом
     void addToStorage(std::shared_ptr<MedicalProduct> product, int quantity);
-    void removeFromStorage(const std::string& productId, int quantity);
+    void receiveLot(std::shared_ptr<MedicalProduct> product, const StockLot& lot);  // Поступление партии (продукт может уже быть)
+    void removeFromStorage(const std::string& productId, int quantity);             // Списание с ранних партий (FEFO)
     int checkStock(const std::string& productId) const;
+    // Замена слушателя под монопольной блокировкой склада: прежний получает 0 по
+    // каждой строке, новый - текущие остатки, поэтому продажи не теряются между ними
+    void setStockListener(StockListener listener);                                  // nullptr - отключение слушателя
+
+    // Бронирование для параллельных касс
+    StockReservation reserve(const std::string& productId, int quantity);
+    void commit(const StockReservation& reservation);                               // Списание забронированных единиц
+    void cancel(const StockReservation& reservation);                               // Возврат единиц в продажу
+    int getAvailableStock(const std::string& productId) const;                      // Остаток за вычетом броней
 
     std::shared_ptr<MedicalProduct> findProduct(const std::string& productNameOrId) const;
 
@@ -45,6 +95,16 @@ public:
     // Получение всех продуктов
     std::vector<std::pair<std::shared_ptr<MedicalProduct>, int>> getAllProducts() const;
 
+    // Партии и сроки годности
+    std::vector<StockLot> getLots(const std::string& productId) const;
+    std::vector<std::pair<std::shared_ptr<MedicalProduct>, StockLot>> removeExpiredLots(const SafeDate& date);
+
+    // Сводки по всему складу
+    long long getTotalUnits() const;
+    double getStockValue() const;                                                   // По базовым ценам
+    std::vector<std::string> getLowStockProducts(int reorderLevel) const;           // ID продуктов ниже порога
+    long long getUnitsExpiringBefore(const SafeDate& date) const;
+
     // Операторы
     Pharmacy& operator=(const Pharmacy& other);
     friend std::ostream& operator<<(std::ostream& os, const Pharmacy& pharmacy);
@@ -6,19 +6,30 @@
 #include <sstream>
 
 PharmacyManager::PharmacyManager()
-    : pharmaciesTree(PharmacyComparator())                        // Инициализация дерева с компаратором для сортировки
+    : pharmaciesTree(PharmacyComparator()),                       // Инициализация дерева с компаратором для сортировки
+      pharmaciesVersion(PharmacyComparator())
 {
 }
 
+PharmacyManager::~PharmacyManager()
+{
+    for (auto it = pharmaciesTree.begin(); it != pharmaciesTree.end(); ++it)        // Аптеки могут пережить менеджер
+        (*it)->setStockListener(nullptr);
+}
+
 void PharmacyManager::addProduct(std::shared_ptr<MedicalProduct> product)
 {
     if (!product)                                                                   // Проверка нулевого указателя
         throw InvalidProductDataException("product", "cannot be null");
 
-    if (productsCatalog.find(product->getId()) != productsCatalog.end())            // Проверка существования продукта
+    auto handle = IdInterner::getInstance().intern(product->getId());               // Хэндл ID продукта
+    if (!productsCatalog.insert(handle, product).second)                            // Проверка существования продукта
         throw DuplicateProductException(product->getId());
+    productsInOrder.push(CatalogEntry(IdInterner::getInstance().name(handle), product));
 
-    productsCatalog[product->getId()] = product;                                    // Добавление продукта в каталог
+    productsSearchIndex.add(product);                                               // Индексация полей для поиска
+    indexSubstance(product);                                                        // Индексация по действующему веществу
+    indexAnalogues(product);                                                        // Аналоги, загруженные вместе с продуктом
 }
 
 void PharmacyManager::removeProduct(const std::string& productId)
@@ -26,22 +37,30 @@ void PharmacyManager::removeProduct(const std::string& productId)
     if (productId.empty())                                                          // Проверка пустого ID
         throw InvalidProductDataException("product ID", "cannot be empty");
 
-    auto it = productsCatalog.find(productId);                                      // Поиск продукта в каталоге
-    if (it == productsCatalog.end())                                                // Если продукт не найден
+    auto handle = IdInterner::getInstance().find(productId);                        // Поиск продукта в каталоге
+    auto entry = productsCatalog.find(handle);
+    if (entry == nullptr)                                                           // Если продукт не найден
         throw ProductNotFoundException(productId);
+    std::shared_ptr<MedicalProduct> product = *entry;                               // Ячейка освобождается при удалении
 
-    // Удаляем продукт из списков аналогов у других лекарств
-    for (auto& [id, product] : productsCatalog)  // <-- Исправлено имя переменной
+    auto referrers = analogueReferrers.find(productId);                             // Лекарства, ссылающиеся на продукт
+    if (referrers != analogueReferrers.end())
     {
-        // Пробуем преобразовать MedicalProduct в Medicine
-        if (auto medicinePtr = std::dynamic_pointer_cast<Medicine>(product)) {  // <-- Другое имя
-            // Теперь medicinePtr - это std::shared_ptr<Medicine>
-            // И мы можем вызвать removeAnalogue()
-            medicinePtr->removeAnalogue(productId);
+        for (const auto& referrerId : referrers->second)                            // Только реальные ссылки - O(степени)
+        {
+            auto referrer = findInCatalog(referrerId);
+            if (referrer == nullptr) continue;
+            if (auto medicine = std::dynamic_pointer_cast<Medicine>(*referrer))
+                medicine->removeAnalogueIfPresent(productId);
         }
+        analogueReferrers.erase(referrers);
     }
 
-    productsCatalog.erase(it);                                                      // Удаление продукта из каталога
+    unindexAnalogues(product);                                                      // Собственные ссылки продукта
+    unindexSubstance(product);
+    productsCatalog.erase(handle);                                                  // Удаление продукта из каталога
+    productsInOrder.erase(std::string_view(productId), CatalogEntryComparator());
+    productsSearchIndex.remove(productId);
 }
 
 std::shared_ptr<MedicalProduct> PharmacyManager::getProduct(const std::string& productId) const
@@ -49,11 +68,11 @@ std::shared_ptr<MedicalProduct> PharmacyManager::getProduct(const std::string& p
     if (productId.empty())                                                          // Проверка пустого ID
         throw InvalidProductDataException("product ID", "cannot be empty");
 
-    auto it = productsCatalog.find(productId);                                      // Поиск продукта в каталоге
-    if (it == productsCatalog.end())                                                // Если продукт не найден
+    auto entry = findInCatalog(productId);                                          // Поиск продукта в каталоге
+    if (entry == nullptr)                                                           // Если продукт не найден
         throw ProductNotFoundException(productId);
 
-    return it->second;                                                              // Возврат найденного продукта
+    return *entry;                                                                  // Возврат найденного продукта
 }
 
 void PharmacyManager::addPharmacy(std::shared_ptr<Pharmacy> pharmacy)
@@ -66,6 +85,27 @@ void PharmacyManager::addPharmacy(std::shared_ptr<Pharmacy> pharmacy)
         throw DuplicateProductException("Pharmacy with ID: " + pharmacy->getId());
 
     pharmaciesTree.push(pharmacy);                                                  // Добавление аптеки в дерево
+    attachPharmacy(pharmacy);                                                       // Индексация уже имеющегося склада
+    pharmaciesVersion.insert(pharmacy);                                             // Читатели видят аптеку с проиндексированным складом
+}
+
+size_t PharmacyManager::addPharmacies(const std::vector<std::shared_ptr<Pharmacy>>& pharmacies)
+{
+    std::vector<std::shared_ptr<Pharmacy>> valid;                                   // Аптеки без нулевых указателей
+    valid.reserve(pharmacies.size());
+    for (const auto& pharmacy : pharmacies)
+        if (pharmacy)
+            valid.push_back(pharmacy);
+
+    size_t before = pharmaciesTree.size();
+    pharmaciesTree.bulk_insert(valid.begin(), valid.end());                         // Дубликаты ID пропускаются деревом
+    for (const auto& pharmacy : valid)
+        if (findPharmacyInTree(pharmacy->getId()) == pharmacy)                      // Только аптеки, попавшие в дерево
+            attachPharmacy(pharmacy);
+
+    pharmaciesVersion.insert(valid.begin(), valid.end());                           // Читатели видят пакет целиком
+
+    return pharmaciesTree.size() - before;                                          // Количество добавленных аптек
 }
 
 void PharmacyManager::removePharmacy(const std::string& pharmacyId)
@@ -73,11 +113,13 @@ void PharmacyManager::removePharmacy(const std::string& pharmacyId)
     if (pharmacyId.empty())                                                         // Проверка пустого ID
         throw InvalidProductDataException("pharmacy ID", "cannot be empty");
 
-    auto pharmacy = findPharmacyInTree(pharmacyId);                                 // Поиск аптеки в дереве
+    auto pharmacy = findPharmacyInTree(pharmacyId);                                 // Поиск аптеки по ID за O(log n)
     if (!pharmacy)                                                                  // Если аптека не найдена
         throw ProductNotFoundException("Pharmacy with ID: " + pharmacyId);
 
-    pharmaciesTree.remove(pharmacy);                                                // Удаление аптеки из дерева
+    detachPharmacy(pharmacy);                                                       // Склад аптеки уходит из индекса
+    pharmaciesTree.erase(pharmacyId, PharmacyComparator());
+    pharmaciesVersion.erase(pharmacyId, PharmacyComparator());
 }
 
 std::shared_ptr<Pharmacy> PharmacyManager::getPharmacy(const std::string& pharmacyId) const
@@ -85,7 +127,8 @@ std::shared_ptr<Pharmacy> PharmacyManager::getPharmacy(const std::string& pharma
     if (pharmacyId.empty())                                                         // Проверка пустого ID
         throw InvalidProductDataException("pharmacy ID", "cannot be empty");
 
-    return findPharmacyInTree(pharmacyId);                                          // Поиск и возврат аптеки
+    auto found = pharmaciesVersion.find(pharmacyId, PharmacyComparator());          // Поиск в опубликованной версии дерева
+    return found ? *found : nullptr;                                                // nullptr - аптека не найдена
 }
 
 void PharmacyManager::addOperation(std::shared_ptr<InventoryOperation> operation)
@@ -93,37 +136,29 @@ void PharmacyManager::addOperation(std::shared_ptr<InventoryOperation> operation
     if (!operation)                                                                 // Проверка нулевого указателя
         throw InvalidProductDataException("operation", "cannot be null");
 
+    if (auto supply = std::dynamic_pointer_cast<Supply>(operation))                 // Тип определяется один раз при добавлении
+        supplyOperations.push_back(supply);
+    else if (auto returnOp = std::dynamic_pointer_cast<Return>(operation))
+        returnOperations.push_back(returnOp);
+    else if (auto writeOff = std::dynamic_pointer_cast<WriteOff>(operation))
+        writeOffOperations.push_back(writeOff);
+
     operations.push_back(operation);                                                // Добавление операции в список
 }
 
-std::vector<std::shared_ptr<Supply>> PharmacyManager::getSupplyOperations() const
+const std::vector<std::shared_ptr<Supply>>& PharmacyManager::getSupplyOperations() const
 {
-    std::vector<std::shared_ptr<Supply>> supplies;                                  // Вектор для операций поставки
-    for (const auto& op : operations)                                               // Проход по всем операциям
-        if (auto supply = std::dynamic_pointer_cast<Supply>(op))                    // Приведение к типу Supply
-            supplies.push_back(supply);                                             // Добавление в результат
-
-    return supplies;                                                                // Возврат списка поставок
+    return supplyOperations;                                                        // Раздел заполняется в addOperation
 }
 
-std::vector<std::shared_ptr<Return>> PharmacyManager::getReturnOperations() const
+const std::vector<std::shared_ptr<Return>>& PharmacyManager::getReturnOperations() const
 {
-    std::vector<std::shared_ptr<Return>> returns;                                   // Вектор для операций возврата
-    for (const auto& op : operations)                                               // Проход по всем операциям
-        if (auto returnOp = std::dynamic_pointer_cast<Return>(op))                  // Приведение к типу Return
-            returns.push_back(returnOp);                                            // Добавление в результат
-
-    return returns;                                                                 // Возврат списка возвратов
+    return returnOperations;
 }
 
-std::vector<std::shared_ptr<WriteOff>> PharmacyManager::getWriteOffOperations() const
+const std::vector<std::shared_ptr<WriteOff>>& PharmacyManager::getWriteOffOperations() const
 {
-    std::vector<std::shared_ptr<WriteOff>> writeOffs;                               // Вектор для операций списания
-    for (const auto& op : operations)                                               // Проход по всем операциям
-        if (auto writeOff = std::dynamic_pointer_cast<WriteOff>(op))                // Приведение к типу WriteOff
-            writeOffs.push_back(writeOff);                                          // Добавление в результат
-
-    return writeOffs;                                                               // Возврат списка списаний
+    return writeOffOperations;
 }
 
 std::vector<std::shared_ptr<MedicalProduct>> PharmacyManager::searchProducts(const std::string& searchTerm) const
@@ -131,19 +166,7 @@ std::vector<std::shared_ptr<MedicalProduct>> PharmacyManager::searchProducts(con
     if (searchTerm.empty())                                                         // Проверка пустой строки поиска
         throw InvalidProductDataException("search term", "cannot be empty");
 
-    std::vector<std::shared_ptr<MedicalProduct>> result;                            // Вектор для результатов
-    for (const auto& pair : productsCatalog)                                        // Проход по всем продуктам
-    {
-        auto product = pair.second;
-        if (product->getName().find(searchTerm) != std::string::npos ||             // Поиск в имени
-            product->getId().find(searchTerm) != std::string::npos ||               // Поиск в ID
-            product->getManufacturerCountry().find(searchTerm) != std::string::npos)// Поиск в стране
-            result.push_back(product);                                              // Добавление продукта в результат
-        else if (auto medicine = std::dynamic_pointer_cast<Medicine>(product))      // Если продукт - лекарство
-            if (medicine->getActiveSubstance().find(searchTerm) != std::string::npos)// Поиск в действующем веществе
-                result.push_back(medicine);                                         // Добавление лекарства в результат
-    }
-    return result;                                                                  // Возврат найденных продуктов
+    return productsSearchIndex.search(searchTerm);                                  // Пересечение списков n-грамм
 }
 
 std::map<std::string, int> PharmacyManager::getProductAvailability(const std::string& productId) const
@@ -151,19 +174,53 @@ std::map<std::string, int> PharmacyManager::getProductAvailability(const std::st
     if (productId.empty())                                                          // Проверка пустого ID
         throw InvalidProductDataException("product ID", "cannot be empty");
 
-    std::map<std::string, int> availability;                                        // Карта доступности продукта
+    StockShard& shard = stockShardFor(productId);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto entry = shard.stockIndex.find(productId);                                  // Один поиск вместо обхода аптек
+    if (entry == shard.stockIndex.end())                                            // Продукта нет ни в одной аптеке
+        return {};
 
-    binaryTree<std::shared_ptr<Pharmacy>> tempTree = pharmaciesTree;                // Создание временной копии дерева
+    std::map<std::string, int> availability;                                        // Карта доступности по аптекам
+    for (const auto& level : entry->second.pharmacies)
+        availability.emplace_hint(availability.end(), level.first, level.second.quantity);
+    return availability;
+}
+
+long long PharmacyManager::getNetworkUnits(const std::string& productId) const
+{
+    StockShard& shard = stockShardFor(productId);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto entry = shard.stockIndex.find(productId);
+    return entry != shard.stockIndex.end() ? entry->second.units : 0;
+}
 
-    for (auto it = tempTree.begin(); it != tempTree.end(); ++it)                    // Обход всех аптек
+PharmacyManager::StockTotals PharmacyManager::getPharmacyTotals(const std::string& pharmacyId) const
+{
+    StockTotals totals;
+    for (StockShard& shard : stockShards)                                           // Сегменты читаются по очереди, продажи не ждут
     {
-        auto pharmacy = *it;
-        int quantity = pharmacy->checkStock(productId);                             // Проверка наличия продукта
-        if (quantity > 0)                                                           // Если продукт есть в наличии
-            availability[pharmacy->getId()] = quantity;                             // Добавление в карту доступности
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto part = shard.pharmacyTotals.find(pharmacyId);
+        if (part == shard.pharmacyTotals.end()) continue;                           // Нет записи - продуктов сегмента нет на складе
+
+        totals.units += part->second.units;
+        totals.value += part->second.value;
+        totals.products += part->second.products;
     }
+    return totals;
+}
 
-    return availability;                                                            // Возврат карты доступности
+PharmacyManager::StockTotals PharmacyManager::getNetworkTotals() const
+{
+    StockTotals totals;
+    for (StockShard& shard : stockShards)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        totals.units += shard.networkTotals.units;
+        totals.value += shard.networkTotals.value;
+        totals.products += shard.stockIndex.size();                                 // Продукты с остатком хотя бы в одной аптеке
+    }
+    return totals;
 }
 
 std::vector<std::pair<std::string, std::string>> PharmacyManager::findProductInPharmacies(const std::string& productNameOrId) const
@@ -171,16 +228,30 @@ std::vector<std::pair<std::string, std::string>> PharmacyManager::findProductInP
     if (productNameOrId.empty())                                                    // Проверка пустой строки поиска
         throw InvalidProductDataException("product name or ID", "cannot be empty");
 
-    std::vector<std::pair<std::string, std::string>> result;                        // Вектор для результатов
+    std::set<std::string> pharmacyIds;                                              // Аптеки в порядке ID без повторов
+    auto collect = [&pharmacyIds](const StockShard& shard, const std::string& productId) {
+        auto entry = shard.stockIndex.find(productId);
+        if (entry != shard.stockIndex.end())
+            for (const auto& level : entry->second.pharmacies)
+                pharmacyIds.insert(level.first);
+    };
 
-    for (auto it = pharmaciesTree.begin(); it != pharmaciesTree.end(); ++it)        // Обход всех аптек
+    for (StockShard& shard : stockShards)                                           // Продукты с таким названием - в любых сегментах
     {
-        auto pharmacy = *it;
-        auto product = pharmacy->findProduct(productNameOrId);                      // Поиск продукта в аптеке
-        if (product)                                                                // Если продукт найден
-            result.emplace_back(pharmacy->getId(), pharmacy->getName());            // Добавление аптеки в результат
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        collect(shard, productNameOrId);                                            // Совпадение по ID (найдется в своем сегменте)
+        auto named = shard.stockedNames.find(productNameOrId);                      // Совпадение по названию
+        if (named != shard.stockedNames.end())
+            for (const auto& productId : named->second)
+                collect(shard, productId);
     }
 
+    std::vector<std::pair<std::string, std::string>> result;                        // Вектор для результатов
+    result.reserve(pharmacyIds.size());
+    for (const auto& pharmacyId : pharmacyIds)
+        if (auto pharmacy = findPharmacyInTree(pharmacyId))
+            result.emplace_back(pharmacy->getId(), pharmacy->getName());
+
     return result;                                                                  // Возврат списка аптек с продуктом
 }
 
@@ -195,22 +266,54 @@ std::vector<std::shared_ptr<Medicine>> PharmacyManager::getAnalogues(const std::
     if (!original)                                                                  // Если продукт не является лекарством
         throw InvalidProductDataException("product", "is not a medicine or not found");
 
-    for (const auto& productPair : productsCatalog)                                 // Проход по всем продуктам
+    auto group = substanceIndex.find(original->getActiveSubstance());               // Лекарства с тем же веществом
+    if (group != substanceIndex.end())
     {
-        auto medicine = std::dynamic_pointer_cast<Medicine>(productPair.second);
-        if (medicine && medicine->getId() != productId &&                           // Не сам продукт
-            medicine->getActiveSubstance() == original->getActiveSubstance())       // Одинаковое действующее вещество
-            analogues.push_back(medicine);                                          // Добавление аналога
+        analogues.reserve(group->second.size());
+        for (const auto& entry : group->second)                                     // Уже упорядочены по ID
+            if (entry.first != productId)                                           // Не сам продукт
+                analogues.push_back(entry.second);                                  // Добавление аналога
     }
 
     return analogues;                                                               // Возврат списка аналогов
 }
 
+void PharmacyManager::addAnalogue(const std::string& medicineId, const std::string& analogueId)
+{
+    auto medicine = getMedicine(medicineId);                                        // Оба продукта должны быть лекарствами
+    auto analogue = getMedicine(analogueId);
+
+    medicine->addAnalogue(analogue);                                                // Проверки дубликатов и самоссылки
+    analogueReferrers[analogueId].insert(medicineId);                               // Обратная ссылка
+}
+
+void PharmacyManager::setAnalogues(const std::string& medicineId, const std::vector<std::string>& analogueIds)
+{
+    auto medicine = getMedicine(medicineId);
+
+    std::vector<std::shared_ptr<Medicine>> analogues;                               // Проверка всех ID до изменений
+    std::unordered_set<std::string> seen;
+    analogues.reserve(analogueIds.size());
+    for (const auto& analogueId : analogueIds)
+    {
+        auto analogue = getMedicine(analogueId);                                    // Исключение - лекарство не изменено
+        if (analogueId != medicineId && seen.insert(analogueId).second)             // Самоссылки и повторы пропускаются
+            analogues.push_back(analogue);
+    }
+
+    unindexAnalogues(medicine);                                                     // Старые связи больше не действуют
+    medicine->clearAnalogues();
+    for (const auto& analogue : analogues)                                          // Список проверен - addAnalogue не бросает
+        medicine->addAnalogue(analogue);
+    indexAnalogues(medicine);
+}
+
 std::vector<std::shared_ptr<MedicalProduct>> PharmacyManager::getAllProducts() const
 {
     std::vector<std::shared_ptr<MedicalProduct>> result;                            // Вектор для всех продуктов
-    for (const auto& pair : productsCatalog)                                        // Проход по всем продуктам
-        result.push_back(pair.second);                                              // Добавление продукта в результат
+    result.reserve(productsInOrder.size());
+    for (const auto& entry : productsInOrder)                                       // Дерево уже упорядочено по ID
+        result.push_back(entry.second);                                             // Добавление продукта в результат
 
     return result;                                                                  // Возврат всех продуктов
 }
@@ -219,26 +322,55 @@ bool PharmacyManager::updateProduct(std::shared_ptr<MedicalProduct> updatedProdu
 {
     std::string id = updatedProduct->getId();
 
-    auto it = productsCatalog.find(id);                                             // Поиск продукта по ID
-    if (it != productsCatalog.end())                                                // Если продукт найден
+    auto handle = IdInterner::getInstance().find(id);
+    auto entry = productsCatalog.find(handle);                                      // Поиск продукта по ID
+    if (entry != nullptr)                                                           // Если продукт найден
     {
-        it->second = updatedProduct;                                                // Обновление продукта
+        unindexSubstance(*entry);                                                   // Вещество могло измениться
+        unindexAnalogues(*entry);
+        *entry = updatedProduct;                                                    // Обновление продукта
+        productsInOrder.erase(std::string_view(id), CatalogEntryComparator());      // Замена за O(log n), ID тот же
+        productsInOrder.push(CatalogEntry(IdInterner::getInstance().name(handle), updatedProduct));
+        productsSearchIndex.add(updatedProduct);                                    // Переиндексация новой версии
+        indexSubstance(updatedProduct);
+        indexAnalogues(updatedProduct);
+        refreshStocked(id, updatedProduct->getName(),                               // Поиск по новому названию,
+                       updatedProduct->getBasePrice());                             // итоги по новой цене
         return true;                                                                // Возврат успеха
     }
 
     return false;                                                                   // Продукт не найден
 }
 
-std::vector<std::shared_ptr<InventoryOperation>> PharmacyManager::getAllOperations() const
+const std::vector<std::shared_ptr<InventoryOperation>>& PharmacyManager::getAllOperations() const
 {
     return operations;                                                              // Возврат всех операций
 }
 
 void PharmacyManager::clearAll()
 {
+    for (auto it = pharmaciesTree.begin(); it != pharmaciesTree.end(); ++it)        // Аптеки больше не сообщают об изменениях
+        (*it)->setStockListener(nullptr);
+
     productsCatalog.clear();                                                        // Очистка каталога продуктов
+    productsInOrder.clear();
+    productsSearchIndex.clear();
+    substanceIndex.clear();
+    analogueReferrers.clear();
+    for (StockShard& shard : stockShards)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.stockIndex.clear();
+        shard.stockedNames.clear();
+        shard.pharmacyTotals.clear();
+        shard.networkTotals = StockTotals();
+    }
     operations.clear();                                                             // Очистка списка операций
+    supplyOperations.clear();
+    returnOperations.clear();
+    writeOffOperations.clear();
     pharmaciesTree.clear();                                                         // Очистка дерева аптек
+    pharmaciesVersion.clear();                                                      // Ранее выданные снимки не затрагиваются
 }
 
 std::vector<std::shared_ptr<Pharmacy>> PharmacyManager::getAllPharmacies() const
@@ -251,14 +383,219 @@ std::vector<std::shared_ptr<Pharmacy>> PharmacyManager::getAllPharmacies() const
     return result;                                                                  // Возврат всех аптек
 }
 
+PharmacyManager::PharmacySnapshot PharmacyManager::getPharmaciesSnapshot() const
+{
+    return pharmaciesVersion.snapshot();                                            // Общие узлы, копируется только корень
+}
+
+std::vector<std::shared_ptr<Pharmacy>> PharmacyManager::getPharmaciesPage(size_t offset, size_t count) const
+{
+    std::vector<std::shared_ptr<Pharmacy>> result;                                  // Вектор для аптек страницы
+    if (offset >= pharmaciesTree.size())                                            // Страница за пределами списка
+        return result;
+
+    result.reserve(std::min(count, pharmaciesTree.size() - offset));                // Резервирование памяти
+    auto it = pharmaciesTree.nth(offset);                                           // Переход к началу страницы за O(log n)
+    for (; it != pharmaciesTree.end() && result.size() < count; ++it)               // Сбор аптек страницы
+        result.push_back(*it);
+
+    return result;                                                                  // Возврат аптек страницы
+}
+
+std::vector<std::shared_ptr<Pharmacy>> PharmacyManager::getPharmaciesInRange(const std::string& fromId,
+                                                                              const std::string& toId) const
+{
+    std::vector<std::shared_ptr<Pharmacy>> result;                                  // Аптеки с ID из [fromId, toId]
+    pharmaciesTree.for_each_in_range(fromId, toId, PharmacyComparator(),            // Обход только нужного отрезка дерева
+                                     [&result](const std::shared_ptr<Pharmacy>& pharmacy) {
+                                         result.push_back(pharmacy);
+                                     });
+    return result;                                                                  // Возврат аптек диапазона
+}
+
+size_t PharmacyManager::getPharmacyCount() const
+{
+    return pharmaciesTree.size();                                                   // Размер дерева за O(1)
+}
+
 std::shared_ptr<Pharmacy> PharmacyManager::findPharmacyInTree(const std::string& pharmacyId) const
 {
-    auto it = pharmaciesTree.find_if([&pharmacyId](const std::shared_ptr<Pharmacy>& pharmacy) {
-        return pharmacy->getId() == pharmacyId;                                     // Поиск по ID аптеки
-    });
+    auto it = pharmaciesTree.find(pharmacyId, PharmacyComparator());               // Спуск по ID за O(log n)
 
     if (it != pharmaciesTree.end())                                                 // Если аптека найдена
         return *it;                                                                 // Возврат найденной аптеки
 
     return nullptr;                                                                 // Аптека не найдена
 }
+
+void PharmacyManager::indexSubstance(const std::shared_ptr<MedicalProduct>& product)
+{
+    if (auto medicine = std::dynamic_pointer_cast<Medicine>(product))               // В индексе только лекарства
+        substanceIndex[medicine->getActiveSubstance()][medicine->getId()] = medicine;
+}
+
+void PharmacyManager::unindexSubstance(const std::shared_ptr<MedicalProduct>& product)
+{
+    auto medicine = std::dynamic_pointer_cast<Medicine>(product);
+    if (!medicine) return;
+
+    auto group = substanceIndex.find(medicine->getActiveSubstance());
+    if (group == substanceIndex.end()) return;
+
+    group->second.erase(medicine->getId());
+    if (group->second.empty())                                                      // Пустые группы не хранятся
+        substanceIndex.erase(group);
+}
+
+void PharmacyManager::indexAnalogues(const std::shared_ptr<MedicalProduct>& product)
+{
+    auto medicine = std::dynamic_pointer_cast<Medicine>(product);
+    if (!medicine) return;
+
+    for (const auto& analogue : medicine->getAnalogues())                           // Обратная ссылка на каждый аналог
+        analogueReferrers[analogue->getId()].insert(medicine->getId());
+}
+
+void PharmacyManager::unindexAnalogues(const std::shared_ptr<MedicalProduct>& product)
+{
+    auto medicine = std::dynamic_pointer_cast<Medicine>(product);
+    if (!medicine) return;
+
+    for (const auto& analogue : medicine->getAnalogues())
+    {
+        auto referrers = analogueReferrers.find(analogue->getId());
+        if (referrers == analogueReferrers.end()) continue;
+
+        referrers->second.erase(medicine->getId());
+        if (referrers->second.empty())                                              // Пустые множества не хранятся
+            analogueReferrers.erase(referrers);
+    }
+}
+
+std::shared_ptr<Medicine> PharmacyManager::getMedicine(const std::string& medicineId) const
+{
+    auto medicine = std::dynamic_pointer_cast<Medicine>(getProduct(medicineId));    // Исключение, если продукта нет
+    if (!medicine)
+        throw InvalidProductDataException("product", "is not a medicine");
+    return medicine;
+}
+
+void PharmacyManager::attachPharmacy(const std::shared_ptr<Pharmacy>& pharmacy)
+{
+    pharmacy->setStockListener([this](const Pharmacy& source, const std::shared_ptr<MedicalProduct>& product, int quantity) {
+        updateStock(source, product, quantity);                                     // Каждое изменение склада обновляет индекс
+    });                                                                             // Имеющийся склад приходит сразу под блокировкой аптеки
+}
+
+void PharmacyManager::detachPharmacy(const std::shared_ptr<Pharmacy>& pharmacy)
+{
+    pharmacy->setStockListener(nullptr);                                            // Записи аптеки обнуляются под той же блокировкой
+}
+
+PharmacyManager::StockShard& PharmacyManager::stockShardFor(const std::string& productId) const
+{
+    return stockShards[std::hash<std::string>()(productId) % stockShardCount];     // Продукт всегда попадает в один сегмент
+}
+
+void PharmacyManager::updateStock(const Pharmacy& pharmacy, const std::shared_ptr<MedicalProduct>& product, int quantity)
+{
+    const std::string productId = product->getId();
+    const std::string pharmacyId = pharmacy.getId();
+    StockShard& shard = stockShardFor(productId);
+    std::lock_guard<std::mutex> lock(shard.mutex);                                  // Порядок изменений одной строки задает аптека
+    if (quantity > 0)                                                               // Новое количество в аптеке
+    {
+        ProductStock& stock = shard.stockIndex[productId];
+        double unitPrice = product->getBasePrice();
+        if (stock.pharmacies.empty())                                               // Продукт появился в сети
+        {
+            stock.name = product->getName();
+            shard.stockedNames[stock.name].insert(productId);
+        }
+        else                                                                        // Склад аптеки может хранить старую версию продукта
+            unitPrice = stock.pharmacies.begin()->second.unitPrice;
+        auto level = stock.pharmacies.try_emplace(pharmacyId, StockLevel{ 0, unitPrice });  // Без узла, если запись есть
+        applyStockChange(shard, pharmacyId, stock, level.first->second, quantity);
+        return;
+    }
+
+    auto entry = shard.stockIndex.find(productId);
+    if (entry == shard.stockIndex.end()) return;
+
+    auto level = entry->second.pharmacies.find(pharmacyId);
+    if (level == entry->second.pharmacies.end()) return;
+
+    applyStockChange(shard, pharmacyId, entry->second, level->second, 0);
+    entry->second.pharmacies.erase(level);
+    if (!entry->second.pharmacies.empty()) return;                                  // Продукт есть в других аптеках
+
+    unindexStockedName(shard, entry->second.name, productId);
+    shard.stockIndex.erase(entry);                                                  // Пустые записи не хранятся
+    if (shard.stockIndex.empty())                                                   // Сегмент пуст - итоги без накопленной погрешности
+        shard.networkTotals = StockTotals();
+}
+
+void PharmacyManager::refreshStocked(const std::string& productId, const std::string& name, double unitPrice)
+{
+    StockShard& shard = stockShardFor(productId);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto entry = shard.stockIndex.find(productId);
+    if (entry == shard.stockIndex.end()) return;                                    // Продукта нет на складах
+
+    for (auto& level : entry->second.pharmacies)                                    // Переоценка остатков каждой аптеки
+    {
+        if (level.second.unitPrice == unitPrice) continue;
+
+        const double valueDelta = level.second.quantity * (unitPrice - level.second.unitPrice);
+        shard.networkTotals.value += valueDelta;
+        auto totals = shard.pharmacyTotals.find(level.first);
+        if (totals != shard.pharmacyTotals.end())                                   // Записи нет только у нулевого остатка
+            totals->second.value += valueDelta;
+        level.second.unitPrice = unitPrice;
+    }
+
+    if (entry->second.name == name) return;                                         // Название не менялось
+
+    unindexStockedName(shard, entry->second.name, productId);
+    entry->second.name = name;
+    shard.stockedNames[name].insert(productId);
+}
+
+void PharmacyManager::unindexStockedName(StockShard& shard, const std::string& name, const std::string& productId)
+{
+    auto named = shard.stockedNames.find(name);
+    if (named == shard.stockedNames.end()) return;
+
+    named->second.erase(productId);
+    if (named->second.empty())                                                      // Пустые множества не хранятся
+        shard.stockedNames.erase(named);
+}
+
+void PharmacyManager::applyStockChange(StockShard& shard, const std::string& pharmacyId, ProductStock& stock,
+                                       StockLevel& level, int quantity)
+{
+    const long long delta = static_cast<long long>(quantity) - level.quantity;
+    const double valueDelta = static_cast<double>(delta) * level.unitPrice;         // Цену учета меняет только refreshStocked
+
+    stock.units += delta;
+    shard.networkTotals.units += delta;
+    shard.networkTotals.value += valueDelta;
+
+    auto totals = shard.pharmacyTotals.try_emplace(pharmacyId).first;
+    totals->second.units += delta;
+    totals->second.value += valueDelta;
+    if (level.quantity == 0 && quantity > 0)                                        // Новая позиция аптеки
+        ++totals->second.products;
+    else if (level.quantity > 0 && quantity == 0)                                   // Позиция ушла со склада
+        --totals->second.products;
+
+    if (totals->second.products == 0)                                               // Продуктов сегмента на складе нет - итоги не хранятся
+        shard.pharmacyTotals.erase(totals);
+
+    level.quantity = quantity;
+}
+
+const std::shared_ptr<MedicalProduct>* PharmacyManager::findInCatalog(const std::string& productId) const
+{
+    return productsCatalog.find(IdInterner::getInstance().find(productId));        // Неизвестный ID - пустой поиск
+}
@@ -8,34 +8,125 @@
 #include "supply.h"
 #include "return.h"
 #include "writeoff.h"
+#include "productsearchindex.h"
+#include "idinterner.h"
 #include "Exception/PharmacyExceptions/InvalidProductDataException.h"
 #include "Exception/PharmacyExceptions/ProductNotFoundException.h"
 #include "Exception/PharmacyExceptions/DuplicateProductException.h"
 #include "my_binary_tree/binarytree.h"  // Добавляем ваше бинарное дерево
+#include "my_binary_tree/concurrent_tree.h"
+#include "my_binary_tree/handle_map.h"
+#include <array>
 #include <memory>
 #include <map>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <functional>
+#include <mutex>
 
 class PharmacyManager
 {
 private:
-    std::map<std::string, std::shared_ptr<MedicalProduct>> productsCatalog;
-    binaryTree<std::shared_ptr<Pharmacy>> pharmaciesTree;
-    std::vector<std::shared_ptr<InventoryOperation>> operations;
-
-    // Компаратор для сравнения аптек по ID
+    // Компаратор для сравнения аптек по ID (допускает поиск по строковому ID)
     struct PharmacyComparator
     {
+        using is_transparent = void;
+
         bool operator()(const std::shared_ptr<Pharmacy>& a, const std::shared_ptr<Pharmacy>& b) const
         {
             return a->getId() < b->getId();
         }
+
+        bool operator()(const std::shared_ptr<Pharmacy>& a, const std::string& id) const
+        {
+            return a->getId() < id;
+        }
+
+        bool operator()(const std::string& id, const std::shared_ptr<Pharmacy>& b) const
+        {
+            return id < b->getId();
+        }
+    };
+
+    using PharmacyTree = binaryTree<std::shared_ptr<Pharmacy>, PharmacyComparator>;
+
+    // Продукт каталога с ID в порядке сортировки (строка принадлежит IdInterner и не освобождается)
+    using CatalogEntry = std::pair<std::string_view, std::shared_ptr<MedicalProduct>>;
+
+    struct CatalogEntryComparator
+    {
+        using is_transparent = void;
+
+        bool operator()(const CatalogEntry& a, const CatalogEntry& b) const { return a.first < b.first; }
+        bool operator()(const CatalogEntry& a, std::string_view id) const { return a.first < id; }
+        bool operator()(std::string_view id, const CatalogEntry& b) const { return id < b.first; }
     };
 
+public:
+    // Неизменяемый снимок списка аптек для отчетов и запросов чтения
+    using PharmacySnapshot = persistent_tree<std::shared_ptr<Pharmacy>, PharmacyComparator>;
+
+    // Итоги по складам (аптеки или всей сети)
+    struct StockTotals
+    {
+        long long units = 0;                                                            // Единиц на складах
+        double value = 0.0;                                                             // Стоимость остатков по базовой цене
+        size_t products = 0;                                                            // Продуктов с ненулевым остатком
+    };
+
+private:
+    struct StockLevel                                                                   // Остаток продукта в одной аптеке
+    {
+        int quantity = 0;
+        double unitPrice = 0.0;                                                         // Цена, по которой остаток учтен в итогах
+    };
+
+    struct ProductStock                                                                 // Наличие продукта по сети
+    {
+        std::map<std::string, StockLevel> pharmacies;                                   // ID аптеки -> остаток
+        long long units = 0;                                                            // Сумма остатков по аптекам
+        std::string name;                                                               // Ключ продукта в stockedNames
+    };
+
+    // Сегмент индекса наличия: продукт всегда попадает в один сегмент по хэшу
+    // ID, поэтому продажи разных продуктов из разных касс обновляют индекс
+    // параллельно. Итоги аптек и сети хранятся по сегментам и складываются
+    // при чтении.
+    struct StockShard
+    {
+        std::mutex mutex;                                                               // Слушатели складов вызываются из касс
+        std::unordered_map<std::string, ProductStock> stockIndex;                       // ID продукта -> наличие по аптекам
+        std::unordered_map<std::string, StockTotals> pharmacyTotals;                    // ID аптеки -> итоги по продуктам сегмента
+        StockTotals networkTotals;                                                      // Итоги сегмента по всей сети
+        std::unordered_map<std::string, std::set<std::string>> stockedNames;           // Название -> ID продуктов сегмента
+    };
+
+    static constexpr size_t stockShardCount = 16;
+
+    handle_map<std::shared_ptr<MedicalProduct>> productsCatalog;                       // Хэндл ID продукта -> продукт
+    binaryTree<CatalogEntry, CatalogEntryComparator> productsInOrder;                   // Те же продукты в порядке ID
+    ProductSearchIndex productsSearchIndex;                                             // n-граммный индекс для searchProducts
+    std::unordered_map<std::string,
+                       std::map<std::string, std::shared_ptr<Medicine>>> substanceIndex;  // Вещество -> лекарства по ID
+    std::unordered_map<std::string, std::unordered_set<std::string>> analogueReferrers; // ID аналога -> ID ссылающихся лекарств
+    mutable std::array<StockShard, stockShardCount> stockShards;                       // Индекс наличия и итоги по сегментам
+    PharmacyTree pharmaciesTree;                                                        // Аптеки по ID (страницы, диапазоны, запись)
+    concurrent_tree<std::shared_ptr<Pharmacy>, PharmacyComparator> pharmaciesVersion;   // Те же аптеки для поиска и снимков из любых потоков
+    std::vector<std::shared_ptr<InventoryOperation>> operations;                       // Все операции в порядке добавления
+    std::vector<std::shared_ptr<Supply>> supplyOperations;                              // Разделы журнала по типам операций
+    std::vector<std::shared_ptr<Return>> returnOperations;
+    std::vector<std::shared_ptr<WriteOff>> writeOffOperations;
+
 public:
     PharmacyManager();
+    ~PharmacyManager();
+
+    PharmacyManager(const PharmacyManager&) = delete;                                   // Аптеки ссылаются на менеджер через слушатель
+    PharmacyManager& operator=(const PharmacyManager&) = delete;
 
     // Управление продуктами
     void addProduct(std::shared_ptr<MedicalProduct> product);
@@ -44,20 +135,30 @@ public:
 
     // Управление аптеками (теперь через бинарное дерево)
     void addPharmacy(std::shared_ptr<Pharmacy> pharmacy);
+    size_t addPharmacies(const std::vector<std::shared_ptr<Pharmacy>>& pharmacies);
     void removePharmacy(const std::string& pharmacyId);
-    std::shared_ptr<Pharmacy> getPharmacy(const std::string& pharmacyId) const;
+    std::shared_ptr<Pharmacy> getPharmacy(const std::string& pharmacyId) const;         // Безопасен при параллельной записи
 
-    // Управление операциями
+    // Управление операциями (списки возвращаются без копирования)
     void addOperation(std::shared_ptr<InventoryOperation> operation);
-    std::vector<std::shared_ptr<Supply>> getSupplyOperations() const;
-    std::vector<std::shared_ptr<Return>> getReturnOperations() const;
-    std::vector<std::shared_ptr<WriteOff>> getWriteOffOperations() const;
-    std::vector<std::shared_ptr<InventoryOperation>> getAllOperations() const;
+    const std::vector<std::shared_ptr<Supply>>& getSupplyOperations() const;
+    const std::vector<std::shared_ptr<Return>>& getReturnOperations() const;
+    const std::vector<std::shared_ptr<WriteOff>>& getWriteOffOperations() const;
+    const std::vector<std::shared_ptr<InventoryOperation>>& getAllOperations() const;
 
     std::vector<std::shared_ptr<MedicalProduct>> searchProducts(const std::string& searchTerm) const;
     std::map<std::string, int> getProductAvailability(const std::string& productId) const;
     std::vector<std::pair<std::string, std::string>> findProductInPharmacies(const std::string& productNameOrId) const;
     std::vector<std::shared_ptr<Medicine>> getAnalogues(const std::string& productId) const;
+
+    // Итоги по складам (поддерживаются при каждом изменении, чтение за O(1))
+    long long getNetworkUnits(const std::string& productId) const;                      // Единиц продукта во всех аптеках
+    StockTotals getPharmacyTotals(const std::string& pharmacyId) const;
+    StockTotals getNetworkTotals() const;
+
+    // Связи аналогов (с обратными ссылками для быстрого удаления продукта)
+    void addAnalogue(const std::string& medicineId, const std::string& analogueId);
+    void setAnalogues(const std::string& medicineId, const std::vector<std::string>& analogueIds);
     std::vector<std::shared_ptr<MedicalProduct>> getAllProducts() const;
 
     bool updateProduct(std::shared_ptr<MedicalProduct> updatedProduct);
@@ -66,10 +167,35 @@ public:
 
     // Метод для получения всех аптек из дерева
     std::vector<std::shared_ptr<Pharmacy>> getAllPharmacies() const;
+    PharmacySnapshot getPharmaciesSnapshot() const;                                     // Снимок за O(1), безопасен при параллельной записи
+    std::vector<std::shared_ptr<Pharmacy>> getPharmaciesPage(size_t offset, size_t count) const;
+    size_t getPharmacyCount() const;
+    std::vector<std::shared_ptr<Pharmacy>> getPharmaciesInRange(const std::string& fromId, const std::string& toId) const;
 
 private:
     // Вспомогательный метод для поиска аптеки в дереве
     std::shared_ptr<Pharmacy> findPharmacyInTree(const std::string& pharmacyId) const;
+    const std::shared_ptr<MedicalProduct>* findInCatalog(const std::string& productId) const;  // nullptr - нет в каталоге
+
+    // Поддержка индекса действующих веществ
+    void indexSubstance(const std::shared_ptr<MedicalProduct>& product);
+    void unindexSubstance(const std::shared_ptr<MedicalProduct>& product);
+
+    // Поддержка обратных ссылок на аналоги
+    void indexAnalogues(const std::shared_ptr<MedicalProduct>& product);
+    void unindexAnalogues(const std::shared_ptr<MedicalProduct>& product);
+    std::shared_ptr<Medicine> getMedicine(const std::string& medicineId) const;
+
+    // Поддержка индекса наличия (обновляется слушателем склада аптеки)
+    void attachPharmacy(const std::shared_ptr<Pharmacy>& pharmacy);
+    void detachPharmacy(const std::shared_ptr<Pharmacy>& pharmacy);
+    StockShard& stockShardFor(const std::string& productId) const;
+    void updateStock(const Pharmacy& pharmacy, const std::shared_ptr<MedicalProduct>& product, int quantity);
+    static void applyStockChange(StockShard& shard, const std::string& pharmacyId, ProductStock& stock,
+                                 StockLevel& level, int quantity);                      // Итоги по разнице остатков
+    void refreshStocked(const std::string& productId, const std::string& name,
+                        double unitPrice);                                              // Новые название и цена продукта в индексе наличия
+    static void unindexStockedName(StockShard& shard, const std::string& name, const std::string& productId);
 };
 
 #endif // PHARMACYMANAGER_H
@@ -0,0 +1,28 @@
+#include "productregistry.h"
+#include <mutex>
+
+ProductRegistry& ProductRegistry::getInstance()
+{
+    static ProductRegistry instance;                                                // Создается при первом обращении
+    return instance;
+}
+
+void ProductRegistry::put(IdInterner::Handle handle, const std::shared_ptr<MedicalProduct>& product)
+{
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        const auto* current = products.find(handle);
+        if (current != nullptr && *current == product)                              // Обычный случай - версия не менялась
+            return;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    products[handle] = product;
+}
+
+std::shared_ptr<MedicalProduct> ProductRegistry::get(IdInterner::Handle handle) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    const auto* product = products.find(handle);
+    return product != nullptr ? *product : nullptr;
+}
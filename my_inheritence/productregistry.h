@@ -0,0 +1,33 @@
+#ifndef PRODUCTREGISTRY_H
+#define PRODUCTREGISTRY_H
+
+#include "medicalproduct.h"
+#include "idinterner.h"
+#include "my_binary_tree/handle_map.h"
+#include <memory>
+#include <shared_mutex>
+
+// Глобальная таблица продуктов по хэндлам ID: строки складов хранят только
+// хэндл, а объект продукта берут отсюда, поэтому указатель на продукт не
+// повторяется в каждой аптеке. Для ID хранится последняя версия продукта,
+// с которой на каком-либо складе появилась строка. Записи не удаляются -
+// как и хэндлы IdInterner, их число ограничено набором ID в программе.
+class ProductRegistry
+{
+private:
+    handle_map<std::shared_ptr<MedicalProduct>> products;                           // Хэндл ID -> последняя версия продукта
+    mutable std::shared_mutex mutex;                                                // Поиски параллельно, замена по одной
+
+    ProductRegistry() = default;
+
+public:
+    ProductRegistry(const ProductRegistry&) = delete;
+    ProductRegistry& operator=(const ProductRegistry&) = delete;
+
+    static ProductRegistry& getInstance();
+
+    void put(IdInterner::Handle handle, const std::shared_ptr<MedicalProduct>& product);  // Замена версии продукта
+    std::shared_ptr<MedicalProduct> get(IdInterner::Handle handle) const;           // nullptr - продукт не регистрировался
+};
+
+#endif // PRODUCTREGISTRY_H
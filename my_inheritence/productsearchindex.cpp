@@ -0,0 +1,185 @@
+#include "productsearchindex.h"
+#include "medicine.h"
+#include <algorithm>
+#include <iterator>
+
+std::string ProductSearchIndex::documentText(const MedicalProduct& product)
+{
+    std::string text = product.getName();                                           // Поля разделяются '\0', чтобы
+    text += '\0';                                                                   // совпадение не склеивало соседние поля
+    text += product.getId();
+    text += '\0';
+    text += product.getManufacturerCountry();
+
+    if (auto medicine = dynamic_cast<const Medicine*>(&product))                    // Приведение только при индексации
+    {
+        text += '\0';
+        text += medicine->getActiveSubstance();
+    }
+    return text;
+}
+
+uint32_t ProductSearchIndex::gramKey(const char* text, size_t length)
+{
+    uint32_t key = static_cast<uint32_t>(length) << 24;                             // Длина в старшем байте
+    for (size_t i = 0; i < length; ++i)
+        key |= static_cast<uint32_t>(static_cast<unsigned char>(text[i])) << (8 * (length - 1 - i));
+    return key;
+}
+
+std::vector<uint32_t> ProductSearchIndex::documentGrams(const std::string& text)
+{
+    std::vector<uint32_t> grams;
+    grams.reserve(text.size() * 2);
+    for (size_t length = 2; length <= 3; ++length)
+    {
+        for (size_t i = 0; i + length <= text.size(); ++i)
+        {
+            if (std::find(text.begin() + i, text.begin() + i + length, '\0') != text.begin() + i + length)
+                continue;                                                           // n-грамма на стыке полей
+            grams.push_back(gramKey(text.data() + i, length));
+        }
+    }
+
+    std::sort(grams.begin(), grams.end());                                          // Каждая n-грамма один раз
+    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+    return grams;
+}
+
+std::vector<uint32_t> ProductSearchIndex::queryGrams(const std::string& term)
+{
+    std::vector<uint32_t> grams;
+    if (term.size() < 2)                                                            // Слишком короткий запрос
+        return grams;
+
+    size_t length = term.size() == 2 ? 2 : 3;                                       // Для длинных запросов - триграммы
+    for (size_t i = 0; i + length <= term.size(); ++i)
+        grams.push_back(gramKey(term.data() + i, length));
+
+    std::sort(grams.begin(), grams.end());
+    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+    return grams;
+}
+
+void ProductSearchIndex::add(const std::shared_ptr<MedicalProduct>& product)
+{
+    if (!product) return;
+
+    remove(product->getId());                                                       // Замена старой версии продукта
+
+    uint32_t slot;
+    if (!freeSlots.empty())                                                         // Повторное использование номера
+    {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else
+    {
+        slot = static_cast<uint32_t>(documents.size());
+        documents.emplace_back();
+    }
+
+    Document& document = documents[slot];
+    document.product = product;
+    document.id = product->getId();
+    document.text = documentText(*product);
+    documentIds[document.id] = slot;
+
+    for (uint32_t gram : documentGrams(document.text))                              // Вставка номера в списки n-грамм
+    {
+        auto& list = postings[gram];
+        if (list.empty() || list.back() < slot)                                     // Обычный случай - новый номер в конец
+            list.push_back(slot);
+        else
+            list.insert(std::lower_bound(list.begin(), list.end(), slot), slot);
+    }
+}
+
+void ProductSearchIndex::remove(const std::string& productId)
+{
+    auto it = documentIds.find(productId);
+    if (it == documentIds.end()) return;
+
+    uint32_t slot = it->second;
+    Document& document = documents[slot];
+
+    for (uint32_t gram : documentGrams(document.text))                              // Удаление номера из списков
+    {
+        auto posting = postings.find(gram);
+        if (posting == postings.end()) continue;
+
+        auto& list = posting->second;
+        auto pos = std::lower_bound(list.begin(), list.end(), slot);
+        if (pos != list.end() && *pos == slot)
+            list.erase(pos);
+        if (list.empty())
+            postings.erase(posting);
+    }
+
+    document.product.reset();
+    document.id.clear();
+    document.text.clear();
+    freeSlots.push_back(slot);
+    documentIds.erase(it);
+}
+
+void ProductSearchIndex::clear()
+{
+    documents.clear();
+    freeSlots.clear();
+    documentIds.clear();
+    postings.clear();
+}
+
+std::vector<std::shared_ptr<MedicalProduct>> ProductSearchIndex::search(const std::string& term) const
+{
+    std::vector<std::shared_ptr<MedicalProduct>> result;
+    if (term.empty()) return result;
+
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> grams = queryGrams(term);
+    if (grams.empty())                                                              // Один символ - проверка всех документов
+    {
+        for (uint32_t slot = 0; slot < documents.size(); ++slot)
+            if (documents[slot].product)
+                candidates.push_back(slot);
+    }
+    else
+    {
+        std::vector<const std::vector<uint32_t>*> lists;
+        lists.reserve(grams.size());
+        for (uint32_t gram : grams)
+        {
+            auto posting = postings.find(gram);
+            if (posting == postings.end())                                          // n-граммы нет ни в одном документе
+                return result;
+            lists.push_back(&posting->second);
+        }
+
+        std::sort(lists.begin(), lists.end(),                                       // Пересечение начинается с короткого списка
+                  [](const std::vector<uint32_t>* a, const std::vector<uint32_t>* b) { return a->size() < b->size(); });
+
+        candidates = *lists.front();
+        std::vector<uint32_t> narrowed;
+        for (size_t i = 1; i < lists.size() && !candidates.empty(); ++i)
+        {
+            narrowed.clear();
+            std::set_intersection(candidates.begin(), candidates.end(),
+                                  lists[i]->begin(), lists[i]->end(), std::back_inserter(narrowed));
+            candidates.swap(narrowed);
+        }
+    }
+
+    std::vector<uint32_t> matches;
+    for (uint32_t slot : candidates)                                                // Точная проверка подстроки
+        if (documents[slot].text.find(term) != std::string::npos)
+            matches.push_back(slot);
+
+    std::sort(matches.begin(), matches.end(),                                       // Порядок как в каталоге
+              [this](uint32_t a, uint32_t b) { return documents[a].id < documents[b].id; });
+
+    result.reserve(matches.size());
+    for (uint32_t slot : matches)
+        result.push_back(documents[slot].product);
+    return result;
+}
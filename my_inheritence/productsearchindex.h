@@ -0,0 +1,47 @@
+#ifndef PRODUCTSEARCHINDEX_H
+#define PRODUCTSEARCHINDEX_H
+
+#include "medicalproduct.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Инвертированный индекс по n-граммам (2 и 3 байта) для поиска подстроки
+// в названии, ID, стране производителя и действующем веществе продукта.
+// Запрос сужается пересечением списков документов для n-грамм запроса,
+// затем кандидаты проверяются точным поиском подстроки.
+class ProductSearchIndex
+{
+private:
+    struct Document
+    {
+        std::shared_ptr<MedicalProduct> product;                                    // nullptr - свободная ячейка
+        std::string id;                                                             // ID продукта (для сортировки без копий)
+        std::string text;                                                           // Поля продукта через '\0'
+    };
+
+    std::vector<Document> documents;                                                // Документы по номерам
+    std::vector<uint32_t> freeSlots;                                                // Номера удаленных документов
+    std::unordered_map<std::string, uint32_t> documentIds;                          // ID продукта -> номер документа
+    std::unordered_map<uint32_t, std::vector<uint32_t>> postings;                   // n-грамма -> отсортированные номера
+
+    static std::string documentText(const MedicalProduct& product);                // Текст для индексации
+    static uint32_t gramKey(const char* text, size_t length);                       // Упаковка n-граммы в число
+    static std::vector<uint32_t> documentGrams(const std::string& text);            // Уникальные 2- и 3-граммы документа
+    static std::vector<uint32_t> queryGrams(const std::string& term);               // n-граммы, обязательные для запроса
+
+public:
+    // Изменение индекса
+    void add(const std::shared_ptr<MedicalProduct>& product);                       // Добавление или замена продукта
+    void remove(const std::string& productId);                                      // Удаление продукта
+    void clear();
+
+    size_t size() const { return documentIds.size(); }
+
+    // Продукты, у которых term входит в одно из полей (в порядке ID)
+    std::vector<std::shared_ptr<MedicalProduct>> search(const std::string& term) const;
+};
+
+#endif // PRODUCTSEARCHINDEX_H
@@ -110,3 +110,31 @@ SafeDate SafeDate::currentDate()
 {
     return SafeDate();                                   // Использование конструктора по умолчанию
 }
+
+int SafeDate::toDayNumber() const
+{
+    int year = getYear();                                // Григорианский календарь, год с марта
+    int month = getMonth();
+    if (month <= 2)                                      // Январь и февраль - конец предыдущего года
+        --year;
+
+    int era = year / 400;                                // Год >= 1900, деление без отрицательных
+    int yearOfEra = year - era * 400;
+    int dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + getDay() - 1;
+    int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;             // Сдвиг к 1970-01-01
+}
+
+SafeDate SafeDate::fromDayNumber(int dayNumber)
+{
+    int days = dayNumber + 719468;                       // Сдвиг к 0000-03-01, как в toDayNumber
+    int era = days / 146097;
+    int dayOfEra = days - era * 146097;
+    int yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    int dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    int shiftedMonth = (5 * dayOfYear + 2) / 153;        // Месяц от марта (0-11)
+    int day = dayOfYear - (153 * shiftedMonth + 2) / 5 + 1;
+    int month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9;
+    int year = yearOfEra + era * 400 + (month <= 2 ? 1 : 0);  // Январь и февраль - следующий год
+    return SafeDate(year, month, day);                   // Проверка года и даты конструктором
+}
@@ -25,6 +25,8 @@ public:
     int getYear() const { return date.tm_year + 1900; }
     int getMonth() const { return date.tm_mon + 1; }
     int getDay() const { return date.tm_mday; }
+    int toDayNumber() const;                             // Номер дня от 1970-01-01 (для сравнения дат числом)
+    static SafeDate fromDayNumber(int dayNumber);        // Обратно к toDayNumber
     static SafeDate fromString(const std::string& dateStr);
 
     static SafeDate currentDate();
@@ -3,17 +3,21 @@
 
 std::ostream& operator<<(std::ostream& os, const StockRecord& record)
 {
-    // Формат: productId;pharmacyId;quantity;YYYY-MM-DD
+    // Формат: productId;pharmacyId;quantity;YYYY-MM-DD[;lotId;YYYY-MM-DD]
     os << record.productId << ";"
        << record.pharmacyId << ";"
        << record.quantity << ";"
        << record.receiptDate.toString();
+    if (record.expirationDate)
+        os << ";" << record.lotId << ";" << record.expirationDate->toString();
     return os;
 }
 
 std::istream& operator>>(std::istream& is, StockRecord& record)
 {
     std::string line;
+    record.lotId.clear();
+    record.expirationDate.reset();
     if (std::getline(is, line)) {
         std::stringstream ss(line);
         std::string token;
@@ -34,6 +38,17 @@ std::istream& operator>>(std::istream& is, StockRecord& record)
             if (sscanf(token.c_str(), "%d-%d-%d", &year, &month, &day) == 3)
                 record.receiptDate = SafeDate(year, month, day);
         }
+
+        // Поля партии есть только в файлах с учетом партий
+        if (std::getline(ss, token, ';'))
+            record.lotId = token;
+
+        if (std::getline(ss, token, ';'))
+        {
+            int year, month, day;
+            if (sscanf(token.c_str(), "%d-%d-%d", &year, &month, &day) == 3)
+                record.expirationDate = SafeDate(year, month, day);
+        }
     }
     return is;
 }
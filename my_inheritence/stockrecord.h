@@ -3,6 +3,7 @@
 #define STOCKRECORD_H
 
 #include "safedate.h"
+#include <optional>
 #include <string>
 #include <iostream>
 
@@ -12,6 +13,8 @@ struct StockRecord
     std::string pharmacyId;   // ID аптеки (с префиксом "Р", например "Р001")
     int quantity;            // Количество
     SafeDate receiptDate;    // Дата поступления
+    std::string lotId;       // Номер партии (необязательное поле)
+    std::optional<SafeDate> expirationDate;  // Срок годности партии (нет - срок продукта)
 
     StockRecord()
         : productId(""), pharmacyId(""), quantity(0), receiptDate(2000, 1, 1) {}
@@ -20,6 +23,11 @@ struct StockRecord
                 int qty, const SafeDate& date)
         : productId(prodId), pharmacyId(pharmId), quantity(qty), receiptDate(date) {}
 
+    StockRecord(const std::string& prodId, const std::string& pharmId, int qty,
+                const SafeDate& date, const std::string& lot, const SafeDate& expiration)
+        : productId(prodId), pharmacyId(pharmId), quantity(qty), receiptDate(date),
+          lotId(lot), expirationDate(expiration) {}
+
     // Операторы для работы с File_text
     friend std::ostream& operator<<(std::ostream& os, const StockRecord& record);
     friend std::istream& operator>>(std::istream& is, StockRecord& record);
@@ -3,43 +3,183 @@
 #include "Exception/InventoryExceptions/NegativeQuantityException.h"
 #include "Exception/InventoryExceptions/InsufficientQuantityException.h"
 #include <algorithm>
+#include <limits>
 #include <stdexcept>
 
 void Storage::addProduct(std::shared_ptr<MedicalProduct> product, int quantity)
 {
     if (!product)                                                                // Проверка нулевого указателя
         throw InventoryException("Product cannot be null");
-    if (quantity <= 0)                                                           // Проверка положительности количества
-        throw NegativeQuantityException(quantity);
 
-    std::string productId = product->getId();                                    // Получение ID продукта
+    StockLot lot;                                                                // Партия без номера, поступившая сегодня
+    lot.receiptDate = SafeDate::currentDate();
+    lot.expirationDate = product->getExpirationSafeDate();                       // Срок годности самого продукта
+    lot.quantity = quantity;
+    addLot(std::move(product), lot);
+}
+
+void Storage::addLot(std::shared_ptr<MedicalProduct> product, const StockLot& lot)
+{
+    if (!product)                                                                // Проверка нулевого указателя
+        throw InventoryException("Product cannot be null");
+    if (lot.quantity <= 0)                                                       // Проверка положительности количества
+        throw NegativeQuantityException(lot.quantity);
 
-    if (items.find(productId) != items.end())                                    // Если продукт уже есть на складе
-        items[productId].second += quantity;                                     // Увеличение количества
-    else                                                                         // Если продукта нет на складе
-        items[productId] = std::make_pair(product, quantity);                    // Добавление нового продукта
+    size_t row = rowFor(product);                                                // Строка продукта (новая - без партий)
+    pushLot(row, { lot.expirationDate.toDayNumber(), lot.receiptDate.toDayNumber(), lot.quantity,
+                   IdInterner::getInstance().intern(lot.lotId) });
+    quantities[row] += lot.quantity;                                             // Увеличение количества
 }
 
 void Storage::removeProduct(const std::string& productId, int quantity)
+{
+    if (takeProduct(productId, quantity) == 0)                                   // Если количество стало нулевым
+        eraseIfEmpty(productId);                                                 // Удаление продукта из хранилища
+}
+
+int Storage::takeProduct(const std::string& productId, int quantity)
+{
+    size_t row = checkedRow(productId, quantity);                                // Поиск продукта по ID
+
+    int available = quantities[row] - reserved[row];                             // Бронь списывать нельзя
+    if (quantity > available)                                                    // Если запрашиваемое количество больше имеющегося
+        throw InsufficientQuantityException(productId, quantity, available);
+
+    consume(row, quantity);
+    return quantities[row];
+}
+
+bool Storage::eraseIfEmpty(const std::string& productId)
+{
+    size_t row = rowOf(productId);
+    if (row == npos || quantities[row] != 0)                                     // Строку успели пополнить
+        return false;
+    eraseRow(row);
+    return true;
+}
+
+void Storage::reserve(const std::string& productId, int quantity)
+{
+    size_t row = checkedRow(productId, quantity);
+
+    int available = quantities[row] - reserved[row];
+    if (quantity > available)                                                    // Бронь не больше свободного остатка
+        throw InsufficientQuantityException(productId, quantity, available);
+
+    reserved[row] += quantity;
+}
+
+void Storage::releaseReservation(const std::string& productId, int quantity)
+{
+    size_t row = checkedRow(productId, quantity);
+    if (quantity > reserved[row])                                                // Снять больше забронированного нельзя
+        throw InventoryException("Reservation exceeds reserved quantity: " + productId);
+
+    reserved[row] -= quantity;
+}
+
+int Storage::commitReservation(const std::string& productId, int quantity)
+{
+    size_t row = checkedRow(productId, quantity);
+    if (quantity > reserved[row])
+        throw InventoryException("Reservation exceeds reserved quantity: " + productId);
+
+    reserved[row] -= quantity;                                                   // Бронь превращается в списание
+    consume(row, quantity);
+    return quantities[row];
+}
+
+void Storage::clearReservations()
+{
+    std::fill(reserved.begin(), reserved.end(), 0);
+}
+
+int Storage::getReserved(const std::string& productId) const
+{
+    size_t row = rowOf(productId);
+    return row != npos ? reserved[row] : 0;
+}
+
+int Storage::getAvailable(const std::string& productId) const
+{
+    size_t row = rowOf(productId);
+    return row != npos ? quantities[row] - reserved[row] : 0;
+}
+
+size_t Storage::checkedRow(const std::string& productId, int quantity) const
 {
     if (productId.empty())                                                       // Проверка пустого ID продукта
         throw InventoryException("Product ID cannot be empty");
     if (quantity <= 0)                                                           // Проверка положительности количества
         throw NegativeQuantityException(quantity);
 
-    auto it = items.find(productId);                                             // Поиск продукта по ID
-    if (it == items.end())                                                       // Если продукт не найден
+    size_t row = rowOf(productId);
+    if (row == npos || quantities[row] == 0)                                     // Если продукт не найден
         throw InventoryException("Product not found: " + productId);
+    return row;
+}
 
-    int& currentQuantity = it->second.second;                                    // Ссылка на текущее количество
+void Storage::consume(size_t row, int quantity)
+{
+    quantities[row] -= quantity;                                                 // Уменьшение количества
+
+    while (quantity > 0)                                                         // Списание с партии, истекающей раньше всех
+    {
+        LotEntry& earliest = firstLots[row];
+        int taken = std::min(quantity, earliest.quantity);
+        earliest.quantity -= taken;                                              // Ключ вершины не меняется
+        quantity -= taken;
+        if (earliest.quantity == 0)                                              // Партия израсходована
+            popLot(row);
+    }
+}
 
-    if (quantity > currentQuantity)                                              // Если запрашиваемое количество больше имеющегося
-        throw InsufficientQuantityException(productId, currentQuantity, quantity);
+std::vector<StockLot> Storage::getLots(const std::string& productId) const
+{
+    std::vector<StockLot> result;
+    size_t row = rowOf(productId);
+    if (row == npos) return result;
 
-    currentQuantity -= quantity;                                                 // Уменьшение количества
+    std::vector<LotEntry> sorted;                                                // Куча упорядочена только по вершине
+    if (firstLots[row].quantity > 0)
+        sorted.push_back(firstLots[row]);
+    if (const auto* more = moreLots(row))
+        sorted.insert(sorted.end(), more->begin(), more->end());
+    std::sort(sorted.begin(), sorted.end(),
+              [](const LotEntry& a, const LotEntry& b) { return expiresLater(b, a); });
 
-    if (currentQuantity == 0)                                                    // Если количество стало нулевым
-        items.erase(it);                                                         // Удаление продукта из хранилища
+    result.reserve(sorted.size());
+    for (const auto& entry : sorted)
+        result.push_back(toStockLot(entry));
+    return result;                                                               // Сначала партии с ранним сроком
+}
+
+std::vector<Storage::ExpiredLot> Storage::removeExpired(int dayNumber)
+{
+    std::vector<ExpiredLot> removed;
+    for (size_t row = 0; row < expiryDays.size();)                               // Строки без истекших партий пропускаются по столбцу
+    {
+        if (expiryDays[row] >= dayNumber)
+        {
+            ++row;
+            continue;
+        }
+
+        std::shared_ptr<MedicalProduct> product = productAt(row);
+        while (firstLots[row].quantity > 0 && firstLots[row].expiryDay < dayNumber  // Снятие истекших партий с вершины
+               && quantities[row] - firstLots[row].quantity >= reserved[row])    // Бронь остается на складе
+        {
+            removed.emplace_back(product, toStockLot(firstLots[row]));
+            quantities[row] -= firstLots[row].quantity;
+            popLot(row);
+        }
+
+        if (quantities[row] == 0)                                                // На место строки встает последняя - номер не растет
+            eraseRow(row);
+        else
+            ++row;
+    }
+    return removed;
 }
 
 int Storage::getQuantity(const std::string& productId) const
@@ -47,9 +187,9 @@ int Storage::getQuantity(const std::string& productId) const
     if (productId.empty())                                                       // Проверка пустого ID продукта
         throw InventoryException("Product ID cannot be empty");
 
-    auto it = items.find(productId);                                             // Поиск продукта по ID
-    if (it != items.end())                                                       // Если продукт найден
-        return it->second.second;                                                // Возврат количества
+    size_t row = rowOf(productId);                                               // Поиск продукта по ID
+    if (row != npos)                                                             // Если продукт найден
+        return quantities[row];                                                  // Возврат количества (0 - строка ждет удаления)
 
     return 0;                                                                    // Продукт не найден, возврат 0
 }
@@ -59,16 +199,224 @@ bool Storage::contains(const std::string& productId) const
     if (productId.empty())                                                       // Проверка пустого ID продукта
         throw InventoryException("Product ID cannot be empty");
 
-    return items.find(productId) != items.end();                                 // Проверка существования продукта
+    size_t row = rowOf(productId);
+    return row != npos && quantities[row] > 0;                                   // Проверка существования продукта
+}
+
+std::shared_ptr<MedicalProduct> Storage::getProduct(const std::string& productId) const
+{
+    size_t row = rowOf(productId);
+    return row != npos && quantities[row] > 0 ? productAt(row) : nullptr;
+}
+
+std::shared_ptr<MedicalProduct> Storage::productAt(size_t row) const
+{
+    return ProductRegistry::getInstance().get(handles[row]);
+}
+
+const std::vector<Storage::LotEntry>* Storage::moreLots(size_t row) const
+{
+    const std::vector<LotEntry>* more = otherLots.find(handles[row]);
+    return more != nullptr && !more->empty() ? more : nullptr;                   // Опустевшая куча удаляется при изменении состава склада
+}
+
+size_t Storage::rowOf(const std::string& productId) const
+{
+    auto handle = IdInterner::getInstance().find(productId);                     // Неизвестный ID не попадет ни в один склад
+    const std::uint32_t* row = rows.find(handle);
+    return row != nullptr ? *row : npos;
+}
+
+bool Storage::expiresLater(const LotEntry& a, const LotEntry& b)
+{
+    if (a.expiryDay != b.expiryDay)                                              // Вершина кучи - ранний срок
+        return a.expiryDay > b.expiryDay;
+    return a.receiptDay > b.receiptDay;                                          // При равных сроках - ранняя поставка
+}
+
+StockLot Storage::toStockLot(const LotEntry& entry)
+{
+    StockLot lot;
+    lot.lotId = IdInterner::getInstance().name(entry.lotId);
+    lot.receiptDate = SafeDate::fromDayNumber(entry.receiptDay);
+    lot.expirationDate = SafeDate::fromDayNumber(entry.expiryDay);
+    lot.quantity = entry.quantity;
+    return lot;
+}
+
+size_t Storage::rowFor(const std::shared_ptr<MedicalProduct>& product)
+{
+    auto handle = IdInterner::getInstance().intern(product->getId());            // Хэндл ID продукта
+
+    auto inserted = rows.insert(handle, static_cast<std::uint32_t>(handles.size()));
+    if (!inserted.second)                                                        // Продукт уже есть на складе
+    {
+        size_t row = *inserted.first;
+        if (quantities[row] == 0)                                                // Строка ждёт удаления - оживляется новым продуктом
+        {
+            ProductRegistry::getInstance().put(handle, product);                 // Старые продукт и цена не должны пережить остаток
+            prices[row] = product->getBasePrice();
+        }
+        return row;
+    }
+
+    ProductRegistry::getInstance().put(handle, product);                         // Версия продукта для всех складов
+    handles.push_back(handle);                                                   // Новая строка во всех столбцах
+    quantities.push_back(0);
+    reserved.push_back(0);
+    expiryDays.push_back(std::numeric_limits<int>::max());
+    prices.push_back(product->getBasePrice());
+    firstLots.push_back({ std::numeric_limits<int>::max(), 0, 0, IdInterner::invalidHandle });
+    return handles.size() - 1;
+}
+
+void Storage::pushLot(size_t row, const LotEntry& entry)
+{
+    LotEntry& first = firstLots[row];
+    if (first.quantity > 0)                                                      // Вторая и следующие партии - в отдельную кучу
+    {
+        std::vector<LotEntry>& heap = otherLots[handles[row]];
+        if (expiresLater(first, entry))                                          // Новая партия истекает раньше вершины
+            std::swap(first, heap.emplace_back(entry));
+        else
+            heap.push_back(entry);
+        std::push_heap(heap.begin(), heap.end(), expiresLater);                  // O(log партий)
+    }
+    else
+    {
+        first = entry;
+        otherLots.erase(handles[row]);                                           // Пустая куча от прежних партий не нужна
+    }
+    expiryDays[row] = first.expiryDay;                                           // Ближайший срок мог сдвинуться
+}
+
+void Storage::popLot(size_t row)
+{
+    std::vector<LotEntry>* heap = otherLots.find(handles[row]);
+    if (heap == nullptr || heap->empty())                                        // Снята последняя партия
+    {
+        firstLots[row] = { std::numeric_limits<int>::max(), 0, 0, IdInterner::invalidHandle };
+        expiryDays[row] = std::numeric_limits<int>::max();
+        return;
+    }
+
+    std::pop_heap(heap->begin(), heap->end(), expiresLater);                     // O(log партий)
+    firstLots[row] = heap->back();                                               // Следующая партия становится вершиной
+    heap->pop_back();
+    expiryDays[row] = firstLots[row].expiryDay;
+}
+
+void Storage::eraseRow(size_t row)
+{
+    size_t last = handles.size() - 1;
+    rows.erase(handles[row]);
+    otherLots.erase(handles[row]);                                               // Партии строки к этому моменту сняты
+
+    if (row != last)                                                             // Последняя строка занимает место удаленной
+    {
+        handles[row] = handles[last];
+        quantities[row] = quantities[last];
+        reserved[row] = reserved[last];
+        expiryDays[row] = expiryDays[last];
+        prices[row] = prices[last];
+        firstLots[row] = firstLots[last];                                        // Остальные партии привязаны к хэндлу, а не к строке
+        *rows.find(handles[row]) = static_cast<std::uint32_t>(row);
+    }
+
+    handles.pop_back();
+    quantities.pop_back();
+    reserved.pop_back();
+    expiryDays.pop_back();
+    prices.pop_back();
+    firstLots.pop_back();
 }
 
 std::vector<std::string> Storage::getAllProductIds() const
 {
     std::vector<std::string> ids;                                                // Вектор для хранения ID
-    ids.reserve(items.size());                                                   // Резервирование памяти
+    ids.reserve(handles.size());                                                 // Резервирование памяти
 
-    for (const auto& item : items)                                               // Проход по всем элементам хранилища
-        ids.push_back(item.first);                                               // Добавление ID в вектор
+    const IdInterner& interner = IdInterner::getInstance();
+    for (size_t row = 0; row < handles.size(); ++row)                            // Проход по столбцу хэндлов
+        if (quantities[row] > 0)
+            ids.push_back(interner.name(handles[row]));                          // Добавление ID в вектор
 
+    std::sort(ids.begin(), ids.end());                                           // Порядок строк не задан
     return ids;                                                                  // Возврат списка ID
 }
+
+std::vector<Storage::Item> Storage::getAllItems() const
+{
+    const IdInterner& interner = IdInterner::getInstance();
+
+    std::vector<std::pair<const std::string*, size_t>> sorted;                   // ID без копирования строк
+    sorted.reserve(handles.size());
+    for (size_t row = 0; row < handles.size(); ++row)
+        if (quantities[row] > 0)
+            sorted.emplace_back(&interner.name(handles[row]), row);
+
+    std::sort(sorted.begin(), sorted.end(),                                      // Сортировка по ID
+              [](const auto& a, const auto& b) { return *a.first < *b.first; });
+
+    std::vector<Item> result;
+    result.reserve(sorted.size());
+    for (const auto& entry : sorted)
+        result.emplace_back(productAt(entry.second), quantities[entry.second]);
+    return result;                                                               // Возврат записей склада
+}
+
+long long Storage::totalUnits() const
+{
+    const int* quantity = quantities.data();
+    const size_t count = quantities.size();
+
+    long long total = 0;                                                         // Простой цикл по столбцу - векторизуется
+    for (size_t i = 0; i < count; ++i)
+        total += quantity[i];
+    return total;
+}
+
+double Storage::valueOnHand() const
+{
+    const int* quantity = quantities.data();
+    const double* price = prices.data();
+    const size_t count = quantities.size();
+
+    double lanes[4] = { 0.0, 0.0, 0.0, 0.0 };                                    // Независимые суммы - порядок сложения задан явно
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+        for (size_t lane = 0; lane < 4; ++lane)
+            lanes[lane] += quantity[i + lane] * price[i + lane];
+    for (; i < count; ++i)                                                       // Хвост
+        lanes[0] += quantity[i] * price[i];
+
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+std::vector<std::string> Storage::getItemsBelow(int reorderLevel) const
+{
+    std::vector<std::string> ids;
+    const IdInterner& interner = IdInterner::getInstance();
+    for (size_t row = 0; row < quantities.size(); ++row)                         // Сравнение идет только по столбцу количеств
+        if (quantities[row] > 0 && quantities[row] < reorderLevel)
+            ids.push_back(interner.name(handles[row]));
+
+    std::sort(ids.begin(), ids.end());                                           // Результат в порядке ID
+    return ids;
+}
+
+long long Storage::unitsExpiringBefore(int dayNumber) const
+{
+    long long total = 0;
+    for (size_t row = 0; row < expiryDays.size(); ++row)
+    {
+        if (expiryDays[row] >= dayNumber)                                        // Ни одна партия строки не истекает
+            continue;
+        total += firstLots[row].quantity;                                        // Срок вершины и есть срок строки
+        if (const auto* more = moreLots(row))
+            for (const auto& entry : *more)
+                if (entry.expiryDay < dayNumber)
+                    total += entry.quantity;
+    }
+    return total;
+}
@@ -2,19 +2,118 @@
 #define STORAGE_H
 
 #include "medicalproduct.h"
+#include "safedate.h"
+#include "idinterner.h"
+#include "productregistry.h"
+#include "my_binary_tree/handle_map.h"
+#include <cstdint>
 #include <map>
 #include <vector>
 #include <memory>
 
-struct Storage
+// Партия продукта на складе
+struct StockLot
 {
-    std::map<std::string, std::pair<std::shared_ptr<MedicalProduct>, int>> items;
+    std::string lotId;                                                           // Номер партии (может быть пустым)
+    SafeDate receiptDate;                                                        // Дата поступления
+    SafeDate expirationDate;                                                     // Срок годности партии
+    int quantity = 0;                                                            // Остаток партии
+};
+
+// Склад в виде структуры массивов: строка i описывается i-ми элементами
+// столбцов. Запросы по всему складу проходят только по нужным столбцам
+// подряд в памяти, не трогая указатели на продукты. Удаление переносит
+// последнюю строку на место удаленной, поэтому порядок строк не задан.
+// Объект продукта строка не хранит: он берется из ProductRegistry по
+// хэндлу ID, так что все склады выдают последнюю поступившую версию.
+// Партии продукта лежат в min-куче по сроку годности: списание идет с
+// партии, истекающей раньше всех (FEFO). Вершина кучи хранится в столбце
+// строки, остальные партии - в отдельной таблице только у строк, где партий
+// больше одной; столбец сроков повторяет срок вершины, чтобы поиск истекших
+// партий шел подряд по памяти. Партия хранится номерами дней и хэндлом
+// номера партии; StockLot собирается заново только при выдаче наружу.
+// Забронированные единицы не могут быть списаны или сняты как истекшие.
+// Склад не синхронизирован: операции с одной строкой (бронь, списание без
+// удаления строки) меняют только ее элементы и могут идти параллельно для
+// разных строк; добавление и удаление строк требуют монопольного доступа.
+// Строка с нулевым остатком может ждать удаления и в выдаче не видна.
+class Storage
+{
+public:
+    using Item = std::pair<std::shared_ptr<MedicalProduct>, int>;                // Продукт и количество
+    using ExpiredLot = std::pair<std::shared_ptr<MedicalProduct>, StockLot>;     // Продукт и снятая партия
+
+private:
+    struct LotEntry                                                              // Партия в куче (16 байт вместо StockLot, 0 единиц - нет партии)
+    {
+        int expiryDay;                                                           // Номер дня срока годности
+        int receiptDay;                                                          // Номер дня поступления (при равных сроках)
+        int quantity;                                                            // Остаток партии
+        IdInterner::Handle lotId;                                                // Хэндл номера партии
+    };
+
+    std::vector<IdInterner::Handle> handles;                                     // Хэндлы ID продуктов
+    std::vector<int> quantities;                                                 // Количества (сумма по партиям)
+    std::vector<int> reserved;                                                   // Забронированные единицы
+    std::vector<int> expiryDays;                                                 // Ближайший срок годности среди партий
+    std::vector<double> prices;                                                  // Базовые цены
+    std::vector<LotEntry> firstLots;                                             // Вершины куч партий (ранний срок)
+    handle_map<std::vector<LotEntry>> otherLots;                                 // Хэндл ID -> остальные партии (min-куча)
+    handle_map<std::uint32_t> rows;                                              // Хэндл ID продукта -> номер строки
+
+    static constexpr size_t npos = static_cast<size_t>(-1);
 
-    void addProduct(std::shared_ptr<MedicalProduct> product, int quantity);
-    void removeProduct(const std::string& productId, int quantity);
+    static bool expiresLater(const LotEntry& a, const LotEntry& b);              // Порядок min-кучи
+    static StockLot toStockLot(const LotEntry& entry);                           // Партия для выдачи (даты из номеров дней)
+    size_t rowOf(const std::string& productId) const;                            // Номер строки (npos - нет на складе)
+    size_t rowFor(const std::shared_ptr<MedicalProduct>& product);               // Номер строки (создается при необходимости)
+    std::shared_ptr<MedicalProduct> productAt(size_t row) const;                 // Продукт строки из ProductRegistry
+    const std::vector<LotEntry>* moreLots(size_t row) const;                     // Партии после вершины (nullptr - нет)
+    void pushLot(size_t row, const LotEntry& entry);                             // Добавление партии в кучу строки
+    void popLot(size_t row);                                                     // Снятие вершины (otherLots не перестраивается)
+    void consume(size_t row, int quantity);                                      // Списание с ранних партий без удаления строки
+    size_t checkedRow(const std::string& productId, int quantity) const;         // Строка продукта с проверкой аргументов
+    void eraseRow(size_t row);                                                   // Удаление строки переносом последней
+
+public:
+    void addProduct(std::shared_ptr<MedicalProduct> product, int quantity);      // Партия со сроком годности продукта
+    void addLot(std::shared_ptr<MedicalProduct> product, const StockLot& lot);
+    void removeProduct(const std::string& productId, int quantity);              // Списание с ранних партий (FEFO)
+    int takeProduct(const std::string& productId, int quantity);                 // Списание без удаления строки (остаток)
+    bool eraseIfEmpty(const std::string& productId);                             // Удаление строки с нулевым остатком
+
+    // Бронирование (бронь уменьшает доступный остаток до подтверждения)
+    void reserve(const std::string& productId, int quantity);
+    void releaseReservation(const std::string& productId, int quantity);         // Отмена брони
+    int commitReservation(const std::string& productId, int quantity);           // Списание брони (остаток, строка не удаляется)
+    void clearReservations();
+    int getReserved(const std::string& productId) const;
+    int getAvailable(const std::string& productId) const;                        // Остаток за вычетом брони
+    std::vector<StockLot> getLots(const std::string& productId) const;           // Партии продукта по сроку годности
+    std::vector<ExpiredLot> removeExpired(int dayNumber);                        // Снятие партий со сроком раньше дня
     int getQuantity(const std::string& productId) const;
     bool contains(const std::string& productId) const;
-    std::vector<std::string> getAllProductIds() const;
+    std::shared_ptr<MedicalProduct> getProduct(const std::string& productId) const;  // nullptr - продукта нет на складе
+    size_t size() const { return handles.size(); }
+    std::vector<std::string> getAllProductIds() const;                           // В порядке ID
+    std::vector<Item> getAllItems() const;                                       // В порядке ID
+
+    template<typename Function>
+    void for_each(Function function) const;                                      // Обход (продукт, количество) в порядке строк
+
+    // Запросы по всему складу
+    long long totalUnits() const;                                                // Всего единиц товара
+    double valueOnHand() const;                                                  // Стоимость запаса по базовым ценам
+    std::vector<std::string> getItemsBelow(int reorderLevel) const;              // ID продуктов с количеством ниже порога
+    long long unitsExpiringBefore(int dayNumber) const;                          // Единиц со сроком раньше дня
 };
 
+template<typename Function>
+void Storage::for_each(Function function) const
+{
+    for (size_t row = 0; row < handles.size(); ++row)
+        if (quantities[row] > 0)                                                 // Строки, ждущие удаления, пропускаются
+            function(productAt(row), quantities[row]);
+}
+
 #endif // STORAGE_H
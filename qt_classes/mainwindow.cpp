@@ -318,19 +318,7 @@ void MainWindow::onAddAnalogue()                               // Добавле
         {
             auto selectedAnalogueIds = dialog.getSelectedAnalogues();
 
-            currentMedicine->clearAnalogues();
-
-            for (const auto& analogueId : selectedAnalogueIds)
-            {
-                auto it = std::find_if(allMedicines.begin(), allMedicines.end(),
-                                       [&analogueId](const std::shared_ptr<Medicine>& med)
-                                       {
-                                           return med->getId() == analogueId;
-                                       });
-
-                if (it != allMedicines.end())
-                    currentMedicine->addAnalogue(*it);
-            }
+            pharmacyManager.setAnalogues(currentMedicine->getId(), selectedAnalogueIds);  // Связи и обратные ссылки
 
             dataModified = true;
             updateActionButtons();
@@ -427,18 +415,7 @@ void MainWindow::loadAllData()                                 // Загрузк
 
         std::vector<std::shared_ptr<Pharmacy>> loadedPharmaciesPtrs;
         if (FileManager::getInstance().loadPharmacies(loadedPharmaciesPtrs))
-        {
-            for (const auto& pharmacyPtr : loadedPharmaciesPtrs)
-            {
-                try
-                {
-                    pharmacyManager.addPharmacy(pharmacyPtr);
-                }
-                catch (const std::exception& e)
-                {
-                }
-            }
-        }
+            pharmacyManager.addPharmacies(loadedPharmaciesPtrs);
 
         std::vector<std::shared_ptr<Medicine>> medicines;
         std::vector<std::shared_ptr<WriteOff>> expiredWriteOffs;
@@ -1168,7 +1145,7 @@ void MainWindow::onSaveChanges()                               // Сохране
     try
     {
         auto allProducts = pharmacyManager.getAllProducts();
-        auto allOperations = pharmacyManager.getAllOperations();
+        const auto& allOperations = pharmacyManager.getAllOperations();
 
         std::vector<std::shared_ptr<InventoryOperation>> existingOperations;
         FileManager::getInstance().loadInventoryOperations(existingOperations);
@@ -194,117 +194,59 @@ void OperationsDialog::loadOperationsData()                    // Загрузк
 
     try
     {
-        std::vector<std::shared_ptr<InventoryOperation>> operations;
+        size_t count = 0;
 
-        switch (currentType)
+        switch (currentType)                                    // Разделы журнала читаются по ссылке, без копий
         {
         case SUPPLY:
         {
-            auto supplies = pharmacyManager.getSupplyOperations();
-            operations.assign(supplies.begin(), supplies.end());
+            const auto& supplies = pharmacyManager.getSupplyOperations();
+            for (const auto& supply : supplies)
+            {
+                int row = addOperationRow(*supply);
+                tableWidget->setItem(row, 4,
+                                     new QTableWidgetItem(QString::fromStdString(supply->getSource())));
+                tableWidget->setItem(row, 5,
+                                     new QTableWidgetItem(QString::fromStdString(supply->getDestination())));
+            }
+            count = supplies.size();
             break;
         }
         case RETURN:
         {
-            auto returns = pharmacyManager.getReturnOperations();
-            operations.assign(returns.begin(), returns.end());
+            const auto& returns = pharmacyManager.getReturnOperations();
+            for (const auto& returnOp : returns)
+            {
+                int row = addOperationRow(*returnOp);
+                tableWidget->setItem(row, 4,
+                                     new QTableWidgetItem(QString::fromStdString(returnOp->getReason())));
+                setStatusCell(row, returnOp->getStatus());
+            }
+            count = returns.size();
             break;
         }
         case WRITEOFF:
         {
-            auto writeOffs = pharmacyManager.getWriteOffOperations();
-            operations.assign(writeOffs.begin(), writeOffs.end());
-            break;
-        }
-        }
-
-        for (size_t i = 0; i < operations.size(); ++i)
-        {
-            const auto& op = operations[i];
-            tableWidget->insertRow(i);
-
-            tableWidget->setItem(i, 0,
-                                 new QTableWidgetItem(QString::fromStdString(op->getId())));
-
-            tableWidget->setItem(i, 1,
-                                 new QTableWidgetItem(QString::fromStdString(op->getOperationDate().toString())));
-
-            tableWidget->setItem(i, 2,
-                                 new QTableWidgetItem(QString::fromStdString(op->getProductId())));
-
-            QTableWidgetItem* quantityItem = new QTableWidgetItem(QString::number(op->getQuantity()));
-            quantityItem->setTextAlignment(Qt::AlignCenter);
-            tableWidget->setItem(i, 3, quantityItem);
-
-            if (currentType == SUPPLY)
-            {
-                if (auto supply = std::dynamic_pointer_cast<Supply>(op))
-                {
-                    tableWidget->setItem(i, 4,
-                                         new QTableWidgetItem(QString::fromStdString(supply->getSource())));
-                    tableWidget->setItem(i, 5,
-                                         new QTableWidgetItem(QString::fromStdString(supply->getDestination())));
-                }
-            }
-            else if (currentType == RETURN)
-            {
-                if (auto returnOp = std::dynamic_pointer_cast<Return>(op))
-                {
-                    tableWidget->setItem(i, 4,
-                                         new QTableWidgetItem(QString::fromStdString(returnOp->getReason())));
-                    tableWidget->setItem(i, 5,
-                                         new QTableWidgetItem(QString::fromStdString(op->getStatus())));
-                }
-            }
-            else if (currentType == WRITEOFF)
+            const auto& writeOffs = pharmacyManager.getWriteOffOperations();
+            for (const auto& writeOff : writeOffs)
             {
-                if (auto writeOff = std::dynamic_pointer_cast<WriteOff>(op))
-                {
-                    tableWidget->setItem(i, 4,
-                                         new QTableWidgetItem(QString::fromStdString(writeOff->getWriteOffReason())));
-                    tableWidget->setItem(i, 5,
-                                         new QTableWidgetItem(QString::fromStdString(op->getStatus())));
-                }
-            }
-
-            if (currentType == RETURN || currentType == WRITEOFF)
-            {
-                QTableWidgetItem* statusItem = tableWidget->item(i, 5);
-                if (statusItem)
-                {
-                    QString status = statusItem->text();
-                    if (status == "completed")
-                    {
-                        statusItem->setBackground(QColor(232, 245, 233));
-                        statusItem->setForeground(QColor(46, 125, 50));
-                    }
-                    else if (status == "pending")
-                    {
-                        statusItem->setBackground(QColor(255, 249, 196));
-                        statusItem->setForeground(QColor(255, 152, 0));
-                    }
-                    else
-                    {
-                        statusItem->setBackground(QColor(255, 235, 238));
-                        statusItem->setForeground(QColor(198, 40, 40));
-                    }
-                }
-            }
-
-            if (op->getQuantity() < 10)
-            {
-                quantityItem->setBackground(QColor(255, 249, 196));
-                quantityItem->setToolTip("Малое количество");
+                int row = addOperationRow(*writeOff);
+                tableWidget->setItem(row, 4,
+                                     new QTableWidgetItem(QString::fromStdString(writeOff->getWriteOffReason())));
+                setStatusCell(row, writeOff->getStatus());
             }
+            count = writeOffs.size();
+            break;
+        }
         }
 
         setWindowTitle(QString("%1 (%2 записей)")
                            .arg(getWindowTitle())
-                           .arg(operations.size()));
+                           .arg(count));
 
         titleLabel->setText(QString("<h2 style='color: #2E7D32; margin: 5px;'>%1 (%2 записей)</h2>")
                                 .arg(getOperationTypeString())
-                                .arg(operations.size()));
+                                .arg(count));
     }
     catch (const std::exception& e)
     {
@@ -313,6 +255,53 @@ void OperationsDialog::loadOperationsData()                    // Загрузк
     }
 }
 
+int OperationsDialog::addOperationRow(const InventoryOperation& op)   // Строка с общими для всех операций столбцами
+{
+    int row = tableWidget->rowCount();
+    tableWidget->insertRow(row);
+
+    tableWidget->setItem(row, 0,
+                         new QTableWidgetItem(QString::fromStdString(op.getId())));
+
+    tableWidget->setItem(row, 1,
+                         new QTableWidgetItem(QString::fromStdString(op.getOperationDate().toString())));
+
+    tableWidget->setItem(row, 2,
+                         new QTableWidgetItem(QString::fromStdString(op.getProductId())));
+
+    QTableWidgetItem* quantityItem = new QTableWidgetItem(QString::number(op.getQuantity()));
+    quantityItem->setTextAlignment(Qt::AlignCenter);
+    tableWidget->setItem(row, 3, quantityItem);
+
+    if (op.getQuantity() < 10)
+    {
+        quantityItem->setBackground(QColor(255, 249, 196));
+        quantityItem->setToolTip("Малое количество");
+    }
+    return row;
+}
+
+void OperationsDialog::setStatusCell(int row, const std::string& status)   // Статус с цветовой отметкой
+{
+    QTableWidgetItem* statusItem = new QTableWidgetItem(QString::fromStdString(status));
+    if (status == "completed")
+    {
+        statusItem->setBackground(QColor(232, 245, 233));
+        statusItem->setForeground(QColor(46, 125, 50));
+    }
+    else if (status == "pending")
+    {
+        statusItem->setBackground(QColor(255, 249, 196));
+        statusItem->setForeground(QColor(255, 152, 0));
+    }
+    else
+    {
+        statusItem->setBackground(QColor(255, 235, 238));
+        statusItem->setForeground(QColor(198, 40, 40));
+    }
+    tableWidget->setItem(row, 5, statusItem);
+}
+
 QString OperationsDialog::getOperationTypeString() const       // Получение строки типа операции
 {
     switch (currentType)
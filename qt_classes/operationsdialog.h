@@ -7,6 +7,7 @@
 #include <string>
 
 class PharmacyManager;
+class InventoryOperation;
 class QTableWidget;
 class QLabel;
 class QComboBox;
@@ -32,6 +33,8 @@ private slots:
 private:
     void setupUI();
     void loadOperationsData();
+    int addOperationRow(const InventoryOperation& op);
+    void setStatusCell(int row, const std::string& status);
     void updateTableColumns();
     QString getOperationTypeString() const;
     QString getWindowTitle() const;